@@ -0,0 +1,92 @@
+#include "body.h"
+#include "frame_timer.h"
+#include "list.h"
+#include "vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Microbenchmark for integrating many bodies: reports body ticks per second
+// of body_tick_list() against calling body_tick() on each body in turn.
+
+const size_t BENCH_BODY_TICKS = 4000000;
+const double BENCH_DT = 1.0 / 240;
+
+double seconds_since(double start) {
+    return frame_timer_now() - start;
+}
+
+list_t *make_square(void) {
+    list_t *shape = list_init(4, free);
+    const vector_t CORNERS[] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    for (size_t i = 0; i < 4; i++) {
+        vector_t *corner = malloc(sizeof(vector_t));
+        *corner = CORNERS[i];
+        list_add(shape, corner);
+    }
+    return shape;
+}
+
+list_t *make_bodies(size_t count) {
+    list_t *bodies = list_init(count, (free_func_t) body_free);
+    for (size_t i = 0; i < count; i++) {
+        body_t *body = body_init(make_square(), 1 + i % 7, (rgb_color_t) {0, 0, 0});
+        body_set_centroid(body, (vector_t) {i % 100, i / 100});
+        body_set_velocity(body, (vector_t) {1, -1});
+        list_add(bodies, body);
+    }
+    return bodies;
+}
+
+/**
+ * Pushes every body, so each tick has forces to integrate.
+ */
+void push_bodies(list_t *bodies) {
+    for (size_t i = 0; i < list_size(bodies); i++) {
+        body_add_force(list_get(bodies, i), (vector_t) {0, -9.8});
+    }
+}
+
+double sum_x(list_t *bodies) {
+    double sum = 0;
+    for (size_t i = 0; i < list_size(bodies); i++) {
+        sum += body_get_centroid(list_get(bodies, i)).x;
+    }
+    return sum;
+}
+
+void bench_body_tick(size_t count) {
+    // Keep the work per size roughly constant
+    size_t ticks = BENCH_BODY_TICKS / count;
+
+    list_t *bodies = make_bodies(count);
+    double start = frame_timer_now();
+    for (size_t t = 0; t < ticks; t++) {
+        push_bodies(bodies);
+        for (size_t i = 0; i < count; i++) {
+            body_tick(list_get(bodies, i), BENCH_DT);
+        }
+    }
+    double loop_time = seconds_since(start);
+    double loop_sum = sum_x(bodies);
+    list_free(bodies);
+
+    bodies = make_bodies(count);
+    start = frame_timer_now();
+    for (size_t t = 0; t < ticks; t++) {
+        push_bodies(bodies);
+        body_tick_list(bodies, 0, count, BENCH_DT);
+    }
+    double list_time = seconds_since(start);
+    double list_sum = sum_x(bodies);
+    list_free(bodies);
+
+    printf("%6zu bodies: body_tick %12.0f ticks/s, body_tick_list %12.0f ticks/s (%.0f, %.0f)\n",
+           count, ticks * count / loop_time, ticks * count / list_time, loop_sum, list_sum);
+}
+
+int main(int argc, char *argv[]) {
+    bench_body_tick(100);
+    bench_body_tick(1000);
+    bench_body_tick(10000);
+    bench_body_tick(100000);
+}
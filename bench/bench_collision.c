@@ -0,0 +1,78 @@
+#include "collision.h"
+#include "frame_timer.h"
+#include "list.h"
+#include "vector.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Microbenchmark for find_collision(): reports calls per second for the
+// list-based API and the allocation-free contiguous API.
+
+const size_t BENCH_CALLS = 2000000;
+// Offsets cycle between overlapping and separated placements, since
+// non-colliding pairs (which exit early) are the common case in a level
+const size_t BENCH_OFFSETS = 8;
+
+list_t *bench_polygon(size_t n, double radius, vector_t center) {
+    list_t *shape = list_init(n, (free_func_t) vec_free);
+    for (size_t i = 0; i < n; i++) {
+        double angle = 2 * M_PI * i / n + M_PI / n;
+        vector_t *v = malloc(sizeof(*v));
+        *v = (vector_t) {center.x + radius * cos(angle), center.y + radius * sin(angle)};
+        list_add(shape, v);
+    }
+    return shape;
+}
+
+vector_t *bench_points(list_t *shape) {
+    vector_t *points = malloc(sizeof(vector_t) * list_size(shape));
+    for (size_t i = 0; i < list_size(shape); i++) {
+        points[i] = *(vector_t *) list_get(shape, i);
+    }
+    return points;
+}
+
+double seconds_since(double start) {
+    return frame_timer_now() - start;
+}
+
+void bench_pair(size_t size1, size_t size2) {
+    list_t *shape1 = bench_polygon(size1, 20, VEC_ZERO);
+    list_t *shapes2[BENCH_OFFSETS];
+    vector_t *points2[BENCH_OFFSETS];
+    for (size_t i = 0; i < BENCH_OFFSETS; i++) {
+        shapes2[i] = bench_polygon(size2, 15, (vector_t) {i * 10.0, 0});
+        points2[i] = bench_points(shapes2[i]);
+    }
+    vector_t *points1 = bench_points(shape1);
+
+    size_t collisions = 0;
+    double start = frame_timer_now();
+    for (size_t i = 0; i < BENCH_CALLS; i++) {
+        collisions += find_collision(shape1, shapes2[i % BENCH_OFFSETS]).collided;
+    }
+    double list_time = seconds_since(start);
+
+    start = frame_timer_now();
+    for (size_t i = 0; i < BENCH_CALLS; i++) {
+        collisions += find_collision_points(points1, size1, points2[i % BENCH_OFFSETS], size2).collided;
+    }
+    double points_time = seconds_since(start);
+
+    printf("%2zu-gon vs %2zu-gon: find_collision %12.0f calls/s, "
+           "find_collision_points %12.0f calls/s (%zu hits)\n",
+           size1, size2, BENCH_CALLS / list_time, BENCH_CALLS / points_time, collisions);
+
+    for (size_t i = 0; i < BENCH_OFFSETS; i++) {
+        list_free(shapes2[i]);
+        free(points2[i]);
+    }
+    list_free(shape1);
+    free(points1);
+}
+
+int main(int argc, char *argv[]) {
+    bench_pair(4, 4);
+    bench_pair(16, 4);
+}
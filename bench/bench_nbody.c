@@ -0,0 +1,58 @@
+#include "frame_timer.h"
+#include "nbody.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Microbenchmark for the gravity kernels: reports the time per tick of
+// exact pairwise gravity and of the Barnes-Hut approximation.
+
+const double BENCH_THETA = 0.5;
+// The exact kernel is quadratic, so it is skipped for the largest sizes
+const size_t BENCH_MAX_PAIRWISE = 20000;
+
+double seconds_since(double start) {
+    return frame_timer_now() - start;
+}
+
+void bench_bodies(size_t n, size_t ticks) {
+    double *x = malloc(n * sizeof(double)), *y = malloc(n * sizeof(double));
+    double *mass = malloc(n * sizeof(double));
+    double *fx = calloc(n, sizeof(double)), *fy = calloc(n, sizeof(double));
+    srand(1);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (double) rand() / RAND_MAX * 1000;
+        y[i] = (double) rand() / RAND_MAX * 500;
+        mass[i] = 50 + rand() % 150;
+    }
+
+    double pairwise_time = NAN;
+    if (n <= BENCH_MAX_PAIRWISE) {
+        double start = frame_timer_now();
+        for (size_t i = 0; i < ticks; i++) {
+            nbody_pairwise_forces(n, x, y, mass, 0.4, 5, fx, fy);
+        }
+        pairwise_time = seconds_since(start) / ticks;
+    }
+
+    double start = frame_timer_now();
+    for (size_t i = 0; i < ticks; i++) {
+        nbody_barnes_hut_forces(n, x, y, mass, 0.4, 5, BENCH_THETA, fx, fy);
+    }
+    double tree_time = seconds_since(start) / ticks;
+
+    printf("%6zu bodies: pairwise %9.3f ms/tick, Barnes-Hut %9.3f ms/tick\n",
+           n, pairwise_time * 1000, tree_time * 1000);
+    free(x);
+    free(y);
+    free(mass);
+    free(fx);
+    free(fy);
+}
+
+int main(int argc, char *argv[]) {
+    bench_bodies(100, 1000);
+    bench_bodies(1000, 20);
+    bench_bodies(10000, 2);
+    bench_bodies(100000, 1);
+}
@@ -0,0 +1,61 @@
+#include "frame_timer.h"
+#include "polygon.h"
+#include "vector.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Microbenchmark for the contiguous polygon kernels: reports calls per second
+// of polygon_points_transform() and polygon_points_project() for every
+// implementation the CPU supports.
+
+const size_t BENCH_VERTICES = 6000000;
+const char *BENCH_KERNEL_NAMES[] = {"scalar", "SSE2", "AVX"};
+
+double seconds_since(double start) {
+    return frame_timer_now() - start;
+}
+
+void bench_polygon(size_t size) {
+    vector_t *local = malloc(sizeof(vector_t) * size);
+    vector_t *world = malloc(sizeof(vector_t) * size);
+    for (size_t i = 0; i < size; i++) {
+        double angle = 2 * M_PI * i / size;
+        local[i] = (vector_t) {20 * cos(angle), 20 * sin(angle)};
+    }
+    // Keep the work per size roughly constant
+    size_t calls = BENCH_VERTICES / size;
+
+    polygon_kernels_t best = polygon_get_kernels();
+    for (polygon_kernels_t kernels = POLYGON_KERNELS_SCALAR; kernels <= best; kernels++) {
+        polygon_set_kernels(kernels);
+        double start = frame_timer_now();
+        for (size_t i = 0; i < calls; i++) {
+            polygon_points_transform(local, world, size, (vector_t) {i, 0}, 0.001 * (i + 1));
+        }
+        double transform_time = seconds_since(start);
+
+        double sum = 0;
+        start = frame_timer_now();
+        for (size_t i = 0; i < calls; i++) {
+            double min, max;
+            vector_t axis = {cos(0.001 * i), sin(0.001 * i)};
+            polygon_points_project(world, size, axis, &min, &max);
+            sum += max - min;
+        }
+        double project_time = seconds_since(start);
+
+        printf("%2zu-gon %-6s: transform %12.0f calls/s, project %12.0f calls/s (%.0f)\n",
+               size, BENCH_KERNEL_NAMES[kernels], calls / transform_time,
+               calls / project_time, sum);
+    }
+    polygon_set_kernels(best);
+    free(local);
+    free(world);
+}
+
+int main(int argc, char *argv[]) {
+    bench_polygon(4);
+    bench_polygon(16);
+    bench_polygon(60);
+}
@@ -49,6 +49,7 @@ body_t *rect_gen(scene_t *scene, double width, double height, double mass, vecto
     *test = c;
 
     body_t *bod = body_init_with_info(rect_pts, mass, color, test, NULL);
+    body_set_tag(bod, c);
     scene_add_body(scene, bod);
     return bod;
 }
@@ -185,6 +186,7 @@ body_t *circle_gen(scene_t *scene, size_t points, vector_t start, double radius,
     }
     polygon_rotate(ball_points, M_PI / points, start);
     body_t *ball_bod = body_init_with_info(ball_points, mass, color, c, (free_func_t) free);
+    body_set_tag(ball_bod, *c);
     if(add){
         scene_add_body(scene, ball_bod);
     }
@@ -243,7 +245,7 @@ void on_key(char key, key_event_type_t type, double held_time, void *scene, vect
                 if(cursor_val){
                     double rect = 0;
                     for(size_t i = 0; i < scene_bodies(scene) - 1; i++){
-                        if(find_collision(body_get_shape(cursor), body_get_shape(scene_get_body(scene, i))).collided){
+                        if(find_body_collision(cursor, scene_get_body(scene, i)).collided){
                             if(find_body_in_scene(scene, 'P', scene_bodies(scene)) == i){
                                 double ind = find_body_in_scene(scene, 'C', scene_bodies(scene));
                                 scene_remove_body(scene, ind);
@@ -36,6 +36,7 @@ body_t *rect_gen(scene_t *scene, double width, double height, double mass, vecto
     *test = c;
 
     body_t *bod = body_init_with_info(rect_pts, mass, color, test, NULL);
+    body_set_tag(bod, c);
     scene_add_body(scene, bod);
     return bod;
 }
@@ -53,6 +54,7 @@ body_t *circle_g(scene_t *scene, size_t points, vector_t start, double radius, d
     char *test = malloc(1);
     *test = c;
     body_t *ball_bod = body_init_with_info(ball_points, mass, color, test, (free_func_t) free);
+    body_set_tag(ball_bod, c);
     scene_add_body(scene, ball_bod);
     return ball_bod;
 }
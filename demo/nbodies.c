@@ -25,6 +25,9 @@ const double MIN_SIZE = 15;
 const double MAX_SIZE = 40;
 
 const double GRAVITY = .4;
+const char STAR_TAG = 'S';
+// Exact pairwise gravity is cheap at this size; use e.g. 0.5 for thousands of stars
+const double GRAVITY_THETA = 0;
 
 list_t *create_star(int n, int size, vector_t center) {
     list_t *ret = list_init(2 * n, (free_func_t) vec_free);
@@ -64,6 +67,7 @@ void add_star(scene_t *scene, int num_sides) {
     double size = fmod((double)rand(), MAX_SIZE - MIN_SIZE + 1) + MIN_SIZE;
 
     body_t *new_star = body_init(create_star(num_sides, size, center), mass, color);
+    body_set_tag(new_star, STAR_TAG);
 
     scene_add_body(scene, new_star);
 }
@@ -74,16 +78,6 @@ void generate_start_bodies(scene_t *scene){
     }   
 }
 
-void create_gravity(scene_t *scene){
-    for (size_t i = 0; i < scene_bodies(scene); i++){
-        for (size_t j = i; j < scene_bodies(scene); j++){
-            if (i != j){
-                create_newtonian_gravity(scene, GRAVITY, scene_get_body(scene, i), scene_get_body(scene, j));
-            }
-        }
-    }
-}
-
 int main(int argc, char *argv[]){
     vector_t min = {MIN_X, MIN_Y};
     vector_t max = {MAX_X, MAX_Y};
@@ -92,10 +86,10 @@ int main(int argc, char *argv[]){
     scene_t *scene = scene_init();
     sdl_init(min, max);
     generate_start_bodies(scene);
+    create_nbody_gravity(scene, GRAVITY, STAR_TAG, GRAVITY_THETA);
 
     while(!sdl_is_done(scene)){
         double dt = time_since_last_tick();
-        create_gravity(scene);
         scene_tick(scene, dt);
         sdl_render_scene(scene);
     }
@@ -9,6 +9,7 @@
 #include "body.h"
 #include "scene.h"
 #include "sdl_wrapper.h"
+#include "stepper.h"
 #include "collision.h"
 #include "textbox.h"
 #include "vector.h"
@@ -22,11 +23,12 @@ const double BALL_MASS = 50.0;
 const vector_t BALL_START = (vector_t) {100.0, 350.0};
 const double BALL_ELASTICITY = .5;
 const vector_t TARZAN_BODY_IMAGE_DIM = (vector_t) {60, 60};
-const size_t TARZAN_NUM_NON_BLINKING_FRAMES = 120;
+// Tarzan keeps his eyes open this long, then blinks one frame at a time
+const double TARZAN_OPEN_EYES_TIME = 3.6;
+const double TARZAN_BLINK_FRAME_TIME = 0.03;
 const size_t TARZAN_NUM_BLINKING_FRAMES = 4;
 
 // Tongue Generating
-const double TONGUE_SPEED = 1500;
 const double TONGUE_WIDTH = 10;
 const rgb_color_t PURPLE_COLOR = (rgb_color_t) {0.388, 0.09, 0.663};
 const double TONGUE_CUTOFF_LENGTH = 300;
@@ -40,13 +42,18 @@ const size_t CURSOR_CIRCLE_INNER_NPOINTS = 40;
 const size_t CURSOR_NUM_CROSSHAIRS = 4;
 const double CURSOR_CROSSHAIR_LENGTH = 4;
 const double CURSOR_DOT_RADIUS = 1;
-const size_t CURSOR_DOT_NPOINTS = 10;
 
 // Friction, Gravity, and Tongue Force
 const double FRICTION_COEFFICIENT = 10;
 const double GRAVITY = 1000;
 const double TONGUE_FORCE = 1300;
 
+// Physics runs at this fixed rate, catching up on slow frames up to a limit
+const double PHYSICS_STEP = 1.0 / 240;
+const size_t MAX_PHYSICS_STEPS = 8;
+// Build with -DPROFILE_FRAMES to print frame timings this often, in seconds
+const double PROFILE_INTERVAL = 1.0;
+
 // Loading Screen
 size_t LOADING_SCREEN_NUM_RECTANGLES = 80;
 double LOADING_SCREEN_RECTANGLE_HEIGHT = 30;
@@ -72,6 +79,9 @@ const double MAX_Y = 500.0;
 const size_t STARTING_LEVEL = 1;
 const size_t NUM_LEVELS = 7;
 
+// Set by the 'q' key to leave the main loop
+bool quit_game = false;
+
 /**
  * Makes the body_t for the closed shape that is the outside of the cursor
  * around location and adds it to scene.
@@ -107,6 +117,7 @@ void draw_cursor_outside(scene_t *scene, vector_t center) {
     char *c = malloc(1);
     *c = 'C';
     body_t *body = body_init_with_info(outside_points, CURSOR_MASS, PURPLE_COLOR, c, (free_func_t) free);
+    body_set_tag(body, *c);
     scene_add_body(scene, body);
     body_set_passive_rotation(body, M_PI / 4);
 }
@@ -118,20 +129,14 @@ void draw_cursor_outside(scene_t *scene, vector_t center) {
  * @param center the center around which to create the cursor dot
  */ 
 void draw_cursor_dot(scene_t *scene, vector_t center) {
-    list_t *dot_points = list_init(CURSOR_DOT_NPOINTS, (free_func_t) vec_free);
-
-    for (size_t i = 0; i < CURSOR_DOT_NPOINTS; i++) {
-        vector_t *v = malloc(sizeof(vector_t));
-        double angle = i * 2 * M_PI / CURSOR_DOT_NPOINTS;
-        *v = (vector_t) {center.x + CURSOR_DOT_RADIUS * cos(angle), center.y + CURSOR_DOT_RADIUS * sin(angle)};
-        list_add(dot_points, v);
-    }
     char *c = malloc(1);
     *c = 'I';
-    scene_add_body(scene, body_init_with_info(dot_points, CURSOR_MASS, PURPLE_COLOR, c, (free_func_t) free));
+    body_t *body = body_init_circle(center, CURSOR_DOT_RADIUS, CURSOR_MASS, PURPLE_COLOR, c, (free_func_t) free);
+    body_set_tag(body, *c);
+    scene_add_body(scene, body);
 }
 
-body_t *rect_gen(scene_t *scene, double width, double height, double mass, vector_t center, rgb_color_t color, char *c, double rotation, list_t *image_list){
+body_t *rect_gen(scene_t *scene, double width, double height, double mass, vector_t center, rgb_color_t color, char *c, double rotation, animation_t *animation){
     list_t *rect_pts = list_init(4, (free_func_t) vec_free);
 
     vector_t *v = malloc(sizeof(*v));
@@ -149,24 +154,14 @@ body_t *rect_gen(scene_t *scene, double width, double height, double mass, vecto
 
     polygon_rotate(rect_pts, rotation, center);
     body_t *bod = body_init_with_info(rect_pts, mass, color, c, free);
-    if (image_list != NULL) {
-        body_add_image_list(bod, image_list);
+    body_set_tag(bod, *c);
+    if (animation != NULL) {
+        body_set_animation(bod, animation);
     }
     scene_add_body(scene, bod);
     return bod;
 }
 
-double find_body_in_scene(scene_t *scene, char type, int start) {
-    double index = start - 1;
-    while(((char *) body_get_info(scene_get_body(scene, index)))[0] != type) {
-        index--;
-        if(index <= -1){
-            return -1;
-        }
-    }
-    return index;
-}
-
 bool cursor_is_outside(body_t *body){
     vector_t center = body_get_centroid(body);
     if(center.x > MAX_X || center.x < MIN_X) {
@@ -196,13 +191,13 @@ void surface_friction(body_t *body1, body_t *body2, vector_t axis, void *aux) {
 void tongue_interaction(body_t *body1, body_t *body2, vector_t axis, void *aux){
     scene_t *scene = (scene_t *) aux;
 
-    if (body_is_removed(body2) || (scene_get_body(scene, find_body_in_scene(scene, 'E', scene_bodies(scene))) == body2 && scene_get_clicked(scene))) {
+    if (body_is_removed(body2) || (scene_get_tagged(scene, 'E') == body2 && scene_get_clicked(scene))) {
         return;
     }
     
-    double index = find_body_in_scene(scene, 'L', scene_bodies(scene));
-    if(index != -1){ 
-        scene_remove_body(scene, index);
+    body_t *tongue = scene_get_tagged(scene, 'L');
+    if(tongue != NULL){ 
+        body_remove(tongue);
     }
 
     vector_t body1_cen = body_get_centroid(body1);
@@ -212,13 +207,13 @@ void tongue_interaction(body_t *body1, body_t *body2, vector_t axis, void *aux){
     
     double distance = sqrt(difference.x * difference.x + difference.y * difference.y);
     if (distance > TONGUE_CUTOFF_LENGTH || cursor_is_outside(body2)) {
-        double index = find_body_in_scene(scene, 'T', scene_bodies(scene));
-        if(index != -1){ 
-            scene_remove_body(scene, index);
+        body_t *tongue_end = scene_get_tagged(scene, 'T');
+        if(tongue_end != NULL){ 
+            body_remove(tongue_end);
         }
-        index = find_body_in_scene(scene, 'L', scene_bodies(scene));
-        if(index != -1){ 
-            scene_remove_body(scene, index);
+        tongue = scene_get_tagged(scene, 'L');
+        if(tongue != NULL){ 
+            body_remove(tongue);
         }
         return;
     }
@@ -235,23 +230,11 @@ void tongue_interaction(body_t *body1, body_t *body2, vector_t axis, void *aux){
     rect_gen(scene, TONGUE_WIDTH, distance, INFINITY, center, PURPLE_COLOR, c, angle, NULL);    
 }
 
-body_t *circle_gen(scene_t *scene, size_t points, vector_t start, double radius, double mass, rgb_color_t color, char *c, bool add, list_t *image_list) {
-    list_t *ball_points = list_init(points, (free_func_t) vec_free);
-    for (size_t i = 0; i < points; i++) {
-        double angle = 2 * M_PI * i / points; 
-        vector_t *v = malloc(sizeof(*v));
-        *v = (vector_t) {start.x + radius * cos(angle), start.y + radius * sin(angle)};
-        list_add(ball_points, v);
-    }
-    polygon_rotate(ball_points, M_PI / points, start);
-    body_t *ball_bod = body_init_with_info(ball_points, mass, color, c, (free_func_t) free);
-    if (image_list != NULL) {
-        // body_add_image(ball_bod, image_init(list_get(image_names, 0), image_dimensions, 0.0));
-        // list_t *images = list_init(list_size(image_names), (free_func_t) image_free);
-        // for(int i = 0; i < list_size(image_names); i++){
-        //     list_add(images, image_init(list_get(image_names, i), image_dimensions, 0.0));
-        // }
-        body_add_image_list(ball_bod, image_list);
+body_t *circle_gen(scene_t *scene, vector_t start, double radius, double mass, rgb_color_t color, char *c, bool add, animation_t *animation) {
+    body_t *ball_bod = body_init_circle(start, radius, mass, color, c, (free_func_t) free);
+    body_set_tag(ball_bod, *c);
+    if (animation != NULL) {
+        body_set_animation(ball_bod, animation);
     }
     if (add) {
         scene_add_body(scene, ball_bod);
@@ -259,23 +242,25 @@ body_t *circle_gen(scene_t *scene, size_t points, vector_t start, double radius,
     return ball_bod;
 }
 
-void freeze_tongue_end(body_t *tongue, body_t *wall, vector_t axis, void *aux) {
-    scene_t *scene = (scene_t *) aux;
+// Whether the tongue can stick to a body; aux is the list of tongue interactables
+bool tongue_can_attach(body_t *body, void *aux) {
+    return list_index_of((list_t *) aux, body) != -1;
+}
+
+// Sticks the end of the tongue to the point where it hit something
+void attach_tongue(scene_t *scene, vector_t point) {
     list_t *interactables = (list_t *) scene_get_extra_info(scene);
-    double index_body = find_body_in_scene(scene, 'T', scene_bodies(scene));
-    double index_player = find_body_in_scene(scene, 'P', scene_bodies(scene));
-    double index_goal = find_body_in_scene(scene, 'E', scene_bodies(scene));
+    body_t *old_tongue = scene_get_tagged(scene, 'T');
+    body_t *player = scene_get_tagged(scene, 'P');
+    body_t *goal = scene_get_tagged(scene, 'E');
 
     char *c = malloc(1);
     *c = 'T';
-    vector_t center = body_get_centroid(tongue);
-    body_t *new_tongue = circle_gen(scene, 10, center, TONGUE_WIDTH / 2, INFINITY, PURPLE_COLOR, c, false, NULL);
-    body_t *player = scene_get_body(scene, index_player);
-
-    body_t *goal = scene_get_body(scene, index_goal);
-    if(find_collision(body_get_shape(new_tongue), body_get_shape(goal)).collided){
+    body_t *new_tongue = circle_gen(scene, point, TONGUE_WIDTH / 2, INFINITY, PURPLE_COLOR, c, false, NULL);
+    if(find_body_collision(new_tongue, goal).collided){
         create_tongue_force(scene, TONGUE_FORCE, player, goal, interactables);
         create_interaction(scene, player, goal, (collision_handler_t) tongue_interaction, scene, NULL);
+        body_free(new_tongue);
     }
     else{
         create_interaction(scene, player, new_tongue, (collision_handler_t) tongue_interaction, scene, NULL);
@@ -283,8 +268,8 @@ void freeze_tongue_end(body_t *tongue, body_t *wall, vector_t axis, void *aux) {
         scene_add_body(scene, new_tongue);
     }
 
-    if (index_body != -1) { 
-        scene_remove_body(scene, index_body);
+    if (old_tongue != NULL) { 
+        body_remove(old_tongue);
     }
 }
 
@@ -305,13 +290,6 @@ void create_viable_player_collisions(scene_t *scene, body_t *player, list_t *pla
     }
 }
 
-void create_viable_tongue_collisions(scene_t *scene, body_t *tongue, list_t *tongue_interactables){
-    for(size_t i = 0; i < list_size(tongue_interactables); i++){
-        body_t *body = list_get(tongue_interactables, i);
-        create_collision(scene, tongue, body, (collision_handler_t) freeze_tongue_end, scene, NULL);
-    }
-}
-
 void bouncy_wall_gen(scene_t *scene, list_t* player_interactables){
     char *c = malloc(1);
     *c = 'W';
@@ -336,33 +314,27 @@ void bouncy_wall_gen(scene_t *scene, list_t* player_interactables){
 }
 
 void tongue_removal(scene_t *scene){
-    int index = scene_bodies(scene) - 1;
-    while(index != -1){
-        if(((char *) body_get_info(scene_get_body(scene, index)))[0] == 'L'){
-            scene_remove_body(scene, index);
-        }
-        index--;
+    list_t *tongues = scene_get_tagged_bodies(scene, 'L');
+    for (size_t i = 0; i < list_size(tongues); i++) {
+        body_remove(list_get(tongues, i));
     }
 }
 
-// Adds all of the frames required for Tarzan to blink to image_list in order
-void add_tarzan_frames(list_t *image_list) {
-    char *image_name = malloc(30);
-    for (size_t i = 0; i < TARZAN_NUM_NON_BLINKING_FRAMES; i++) {
-        image_name = malloc(30);
-        sprintf(image_name, "images/tarzan-ball.png");
-        list_add(image_list, image_init(image_name, TARZAN_BODY_IMAGE_DIM, 0));
-    }
+// Returns Tarzan's looping blink animation
+animation_t *tarzan_animation() {
+    animation_t *animation = animation_init(ANIMATION_LOOP);
+    animation_add_frame(animation, image_init("images/tarzan-ball.png", TARZAN_BODY_IMAGE_DIM, 0),
+            TARZAN_OPEN_EYES_TIME);
 
+    char image_name[30];
     for (size_t i = 1; i <= TARZAN_NUM_BLINKING_FRAMES; i++) {
-        image_name = malloc(30);
         sprintf(image_name, "images/tarzan-blink-%zu.png", i);
-        list_add(image_list, image_init(image_name, TARZAN_BODY_IMAGE_DIM, 0));    
+        animation_add_frame(animation, image_init(image_name, TARZAN_BODY_IMAGE_DIM, 0), TARZAN_BLINK_FRAME_TIME);
     }
 
-    image_name = malloc(30);
-    sprintf(image_name, "images/tarzan-blink-1.png");
-    list_add(image_list, image_init(image_name, TARZAN_BODY_IMAGE_DIM, 0));
+    animation_add_frame(animation, image_init("images/tarzan-blink-1.png", TARZAN_BODY_IMAGE_DIM, 0),
+            TARZAN_BLINK_FRAME_TIME);
+    return animation;
 }
 
 void circ_draw(scene_t *scene, char *line, bool player_added, list_t *player_interactables, list_t *tongue_interactables){
@@ -378,23 +350,21 @@ void circ_draw(scene_t *scene, char *line, bool player_added, list_t *player_int
     }
 
     char *c = malloc(1);
-    list_t *image_list = list_init(2, (free_func_t) image_free);
+    animation_t *animation;
     if (strtod(list_get(list, 8), &holder) == 0) {
         *c = 'P';
-        add_tarzan_frames(image_list);
+        animation = tarzan_animation();
     }
     else {
         *c = 'E';
-        char *image_name = malloc(20);
-        image_name = "images/target-image.png";
-        image_t *image = image_init(image_name, (vector_t) {40, 40}, 0);
-        list_add(image_list, image);
+        animation = animation_init_still(image_init("images/target-image.png", (vector_t) {40, 40}, 0));
     }
 
-    body_t *body = circle_gen(scene, strtod(list_get(list, 0), &holder), (vector_t) {strtod(list_get(list, 1),
+    // The first field is the number of vertices, which circles no longer need
+    body_t *body = circle_gen(scene, (vector_t) {strtod(list_get(list, 1),
             &holder), strtod(list_get(list, 2), &holder)}, strtod(list_get(list, 3), &holder), strtod(list_get(list, 4),
             &holder), (rgb_color_t) {strtod(list_get(list, 5), &holder), strtod(list_get(list, 6), &holder),
-            strtod(list_get(list, 7), &holder)}, c, true, image_list);
+            strtod(list_get(list, 7), &holder)}, c, true, animation);
     if (player_added) {
         list_add(player_interactables, body);
         list_add(tongue_interactables, body);
@@ -416,31 +386,30 @@ void rect_draw(scene_t *scene, char *line, list_t *player_interactables, list_t
 		ptr = strtok(NULL, delim);
 	}
 
-    char *image_name = malloc(20);
+    char *image_name;
     char *c = malloc(1);
     if (strtod(list_get(list, 8), &holder) == 0) {
         *c = 'W';
-        sprintf(image_name, "images/floor.png");
+        image_name = "images/floor.png";
     }
     else {
         *c = 'K';
-        sprintf(image_name, "images/lava.png");
+        image_name = "images/lava.png";
     }
 
-    list_t *image_list = list_init(1, (free_func_t) image_free);
-    list_add(image_list, image_init(image_name, (vector_t) {strtod(list_get(list, 0), &holder),
+    animation_t *animation = animation_init_still(image_init(image_name, (vector_t) {strtod(list_get(list, 0), &holder),
             strtod(list_get(list, 1), &holder)}, strtod(list_get(list, 9), &holder) * -180 / M_PI));
     
     body_t *body = rect_gen(scene, strtod(list_get(list, 0), &holder), strtod(list_get(list, 1), &holder),
             strtod(list_get(list, 2), &holder), (vector_t) {strtod(list_get(list, 3), &holder), strtod(list_get(list, 4),
             &holder)}, (rgb_color_t) {strtod(list_get(list, 5), &holder), strtod(list_get(list, 6), &holder),
-            strtod(list_get(list, 7), &holder)}, c, strtod(list_get(list, 9), &holder), image_list);
+            strtod(list_get(list, 7), &holder)}, c, strtod(list_get(list, 9), &holder), animation);
     
     
     //list_add(INTERACTABLES, body);
 
     if(*c == 'K'){
-        create_half_destruction(scene, body, scene_get_body(scene, find_body_in_scene(scene, 'P', scene_bodies(scene))));
+        create_half_destruction(scene, body, scene_get_tagged(scene, 'P'));
         list_add(player_interactables, body);
     }
     else{
@@ -545,10 +514,10 @@ void generate_menu_button_body(scene_t *scene) {
     char *c = malloc(1);
     *c = 'R';
     body_t *menu_button = body_init_with_info(rounded_rec_pts, INFINITY, PURPLE_COLOR, c, free);
+    body_set_tag(menu_button, *c);
 
-    list_t *image_list = list_init(1, (free_func_t) image_free);
-    list_add(image_list, image_init("images/button.png", (vector_t) {2 * width + 2, 2 * height + 2}, 0));
-    body_add_image_list(menu_button, image_list);
+    body_set_animation(menu_button,
+            animation_init_still(image_init("images/button.png", (vector_t) {2 * width + 2, 2 * height + 2}, 0)));
     scene_add_body(scene, menu_button);
 }
 
@@ -588,7 +557,7 @@ scene_t *set_up_level(size_t level_num) {
 
 textbox_t *make_menu_button() {
     return textbox_init(MENU_BUTTON_TEXT_TOP_LEFT.x, MENU_BUTTON_TEXT_TOP_LEFT.y,
-                MENU_BUTTON_TEXT_DIMENSIONS.x, MENU_BUTTON_TEXT_DIMENSIONS.y, "Menu", TTF_OpenFont("fonts/Skranji-Regular.ttf", 120), MENU_BUTTON_TEXT_COLOR);
+                MENU_BUTTON_TEXT_DIMENSIONS.x, MENU_BUTTON_TEXT_DIMENSIONS.y, "Menu", "fonts/Skranji-Regular.ttf", 120, MENU_BUTTON_TEXT_COLOR);
 }
 
 list_t *default_tbs() {
@@ -600,11 +569,11 @@ list_t *default_tbs() {
 list_t *make_tutorial(){
     list_t *ret = list_init(2, (free_func_t) textbox_free);
     textbox_t *one = textbox_init(100, 100, 800, 45, "Press and hold the mouse to shoot your tongue and move!", 
-                                      TTF_OpenFont("fonts/karvwood.otf", 200), (SDL_Color) {255, 0, 255});
+                                      "fonts/karvwood.otf", 200, (SDL_Color) {255, 0, 255});
     list_add(ret, one);
     list_add(ret, make_menu_button());
     textbox_t *five = textbox_init(375, 150, 250, 45, "Press \'p\' to pause", 
-                TTF_OpenFont("fonts/karvwood.otf", 150), (SDL_Color) {255, 0, 255});
+                "fonts/karvwood.otf", 150, (SDL_Color) {255, 0, 255});
     list_add(ret, five);
     return ret;
 }
@@ -612,17 +581,17 @@ list_t *make_tutorial(){
 list_t *make_menu_text() {
     list_t *ret = list_init(2, (free_func_t) textbox_free);
     textbox_t *one = textbox_init(300, 120, 400, 100, "Menu", 
-                TTF_OpenFont("fonts/karvwood.otf", 160), (SDL_Color) {0, 200, 0});
+                "fonts/karvwood.otf", 160, (SDL_Color) {0, 200, 0});
     list_add(ret, one);
     list_add(ret, make_menu_button());
     textbox_t *five = textbox_init(400, 220, 200, 25, "Press \'p\' to play", 
-                TTF_OpenFont("fonts/karvwood.otf", 150), (SDL_Color) {0, 200, 0});
+                "fonts/karvwood.otf", 150, (SDL_Color) {0, 200, 0});
     list_add(ret, five);
     textbox_t *three = textbox_init(310, 265, 380, 25, "Press \'r\' to go to restart level", 
-                TTF_OpenFont("fonts/karvwood.otf", 150), (SDL_Color) {0, 200, 0});
+                "fonts/karvwood.otf", 150, (SDL_Color) {0, 200, 0});
     list_add(ret, three);
     textbox_t *four = textbox_init(400, 310, 200, 25, "Press \'q\' to quit", 
-                TTF_OpenFont("fonts/karvwood.otf", 150), (SDL_Color) {0, 200, 0});
+                "fonts/karvwood.otf", 150, (SDL_Color) {0, 200, 0});
     list_add(ret, four);
     return ret;
 }
@@ -630,22 +599,22 @@ list_t *make_menu_text() {
 list_t *make_win_text() {
     list_t *ret = list_init(2, (free_func_t) textbox_free);
     textbox_t *one = textbox_init(100, 25, 800, 60, "CONGRATULATIONS.", 
-                TTF_OpenFont("fonts/karvwood.otf", 100), (SDL_Color) {112, 39, 195});
+                "fonts/karvwood.otf", 100, (SDL_Color) {112, 39, 195});
     list_add(ret, one);
     textbox_t *four = textbox_init(375, 80, 250, 60, "YOU WIN!", 
-                TTF_OpenFont("fonts/karvwood.otf", 100), (SDL_Color) {0, 175, 0});
+                "fonts/karvwood.otf", 100, (SDL_Color) {0, 175, 0});
     list_add(ret, four);
     textbox_t *two = textbox_init(300, 350, 400, 30, "Press 'r' to restart game",
-                TTF_OpenFont("fonts/karvwood.otf", 120), (SDL_Color) {112, 39, 195});
+                "fonts/karvwood.otf", 120, (SDL_Color) {112, 39, 195});
     list_add(ret, two);
     textbox_t *three = textbox_init(400, 400, 200, 30, "Press 'q' to quit", 
-                TTF_OpenFont("fonts/karvwood.otf", 120), (SDL_Color) {112, 39, 195});
+                "fonts/karvwood.otf", 120, (SDL_Color) {112, 39, 195});
     list_add(ret, three);
     textbox_t *five = textbox_init(50, 440, 900, 25, "Game developers: Julian \"Takis\" Peres, Kyle \"Cookies\" McCandless, Daniel \"Hops\" Wen, Ishaan \"Simp\" Kannan", 
-                TTF_OpenFont("fonts/Skranji-Regular.ttf", 120), (SDL_Color) {0, 160, 0});
+                "fonts/Skranji-Regular.ttf", 120, (SDL_Color) {0, 160, 0});
     list_add(ret, five);
     textbox_t *six = textbox_init(325, 470, 350, 25, "...and Sarah for helping us along the way :)", 
-                TTF_OpenFont("fonts/Skranji-Regular.ttf", 120), (SDL_Color) {0, 160, 0});
+                "fonts/Skranji-Regular.ttf", 120, (SDL_Color) {0, 160, 0});
     list_add(ret, six);
     return ret;
 }
@@ -653,53 +622,48 @@ list_t *make_win_text() {
 list_t *make_loss_text() {
     list_t *ret = list_init(2, (free_func_t) textbox_free);
     textbox_t *one = textbox_init(300, 150, 400, 40, "YOU DIED.", 
-                TTF_OpenFont("fonts/karvwood.otf", 160), (SDL_Color) {0, 200, 0});
+                "fonts/karvwood.otf", 160, (SDL_Color) {0, 200, 0});
     list_add(ret, one);
     list_add(ret, make_menu_button());
     textbox_t *three = textbox_init(310, 240, 380, 25, "Press \'r\' to go to replay level", 
-                TTF_OpenFont("fonts/karvwood.otf", 150), (SDL_Color) {0, 200, 0});
+                "fonts/karvwood.otf", 150, (SDL_Color) {0, 200, 0});
     list_add(ret, three);
     textbox_t *four = textbox_init(400, 300, 200, 25, "Press \'q\' to quit", 
-                TTF_OpenFont("fonts/karvwood.otf", 150), (SDL_Color) {0, 200, 0});
+                "fonts/karvwood.otf", 150, (SDL_Color) {0, 200, 0});
     list_add(ret, four);
     return ret;
 }
 
 void on_key(char key, key_event_type_t type, double held_time, void *scene, vector_t loc) {
-    double cursor_out_index = find_body_in_scene(scene, 'C', scene_bodies(scene));
-    double cursor_dot_index = find_body_in_scene(scene, 'I', scene_bodies(scene));
-    double player_index = find_body_in_scene(scene, 'P', scene_bodies(scene));
-    double menu_button_index = find_body_in_scene(scene, 'R', scene_bodies(scene));
-    double target_index = find_body_in_scene(scene, 'E', scene_bodies(scene));
-    if (cursor_out_index == -1 || cursor_dot_index == -1 || player_index == -1 || menu_button_index == -1 || target_index == -1) {    
+    body_t *cursor_out = scene_get_tagged(scene, 'C');
+    body_t *cursor_dot = scene_get_tagged(scene, 'I');
+    body_t *player = scene_get_tagged(scene, 'P');
+    body_t *menu_button = scene_get_tagged(scene, 'R');
+    body_t *target = scene_get_tagged(scene, 'E');
+    if (cursor_out == NULL || cursor_dot == NULL || player == NULL || menu_button == NULL || target == NULL) {    
         return;
     }
 
     loc = (vector_t) {loc.x, MAX_Y - loc.y};
-    body_t *cursor_out = scene_get_body((scene_t *) scene, cursor_out_index);
-    body_t *cursor_dot = scene_get_body((scene_t *) scene, cursor_dot_index);
-    body_t *player = scene_get_body((scene_t *) scene, player_index);
-    body_t *menu_button = scene_get_body((scene_t *) scene, menu_button_index);
-    body_t *target = scene_get_body((scene_t *) scene, target_index);
     
     if (type == KEY_PRESSED) {
         switch (key) {
             case MOUSE_CLICK: {
                 if (! scene_show_text_image(scene, 0)) {
                     // If the user clicks on the menu button, display the menu image
-                    if (find_collision(body_get_shape(cursor_dot), body_get_shape(menu_button)).collided) {
+                    if (find_body_collision(cursor_dot, menu_button).collided) {
                         scene_set_pause(scene, true);
                         scene_set_show_text_image(scene, 0, true);
                         break;
                     }
 
-                    char *c = malloc(1);
-                    *c = 'T';
-                    body_t *tongue_end = circle_gen(scene, 3, body_get_centroid(player), 3, INFINITY, PURPLE_COLOR, c, true, NULL);
+                    // The tongue sticks to the first thing in its way, if it can reach it
                     vector_t direction = tongue_direction(player, cursor_dot);
-                    body_set_velocity(tongue_end, vec_multiply(TONGUE_SPEED, direction));
-                    create_interaction(scene, player, tongue_end, (collision_handler_t) tongue_interaction, scene, NULL);
-                    create_viable_tongue_collisions(scene, tongue_end, scene_get_extra_info(scene));
+                    ray_hit_t hit;
+                    if (scene_raycast(scene, body_get_centroid(player), direction, TONGUE_CUTOFF_LENGTH,
+                                      tongue_can_attach, scene_get_extra_info(scene), &hit) != NULL) {
+                        attach_tongue(scene, hit.point);
+                    }
                     scene_set_clicked(scene, false);
                     break;
                 }
@@ -707,9 +671,8 @@ void on_key(char key, key_event_type_t type, double held_time, void *scene, vect
             }
             case Q_KEY: {
                 if (scene_show_text_image(scene, 0) || scene_show_text_image(scene, 1) || scene_show_text_image(scene, 2)) {
-                    scene_free(scene);
-                    sdl_free();
-                    exit(0);
+                    // Quit from main() so the textboxes are freed before SDL
+                    quit_game = true;
                 }
                 break;
             }
@@ -717,7 +680,7 @@ void on_key(char key, key_event_type_t type, double held_time, void *scene, vect
                 // If any text image is shown, do the signal to restart level and hide the text image
                 for (size_t i = 0; i < list_size(scene_get_text_images(scene)); i++) {
                     if (scene_show_text_image(scene, i)) {
-                        body_set_elasticity(scene_get_body(scene, find_body_in_scene(scene, 'R', scene_bodies(scene))), 2);
+                        body_set_elasticity(menu_button, 2);
                         scene_set_show_text_image(scene, i, false);
                         break;
                     }
@@ -743,9 +706,9 @@ void on_key(char key, key_event_type_t type, double held_time, void *scene, vect
         switch(key) {
             case MOUSE_CLICK: {
                 scene_set_clicked(scene, true);
-                double index = find_body_in_scene(scene, 'T', scene_bodies(scene));
-                if(index != -1){
-                    scene_remove_body(scene, index);
+                body_t *tongue_end = scene_get_tagged(scene, 'T');
+                if(tongue_end != NULL){
+                    body_remove(tongue_end);
                 }
 
                 list_t *forces = scene_get_forces(scene);
@@ -759,7 +722,7 @@ void on_key(char key, key_event_type_t type, double held_time, void *scene, vect
                     body_t *body1 = (body_t *) list_get(bodies, 0);
                     body_t *body2 = (body_t *) list_get(bodies, 1);
                     if ((body1 == player && body2 == target) || (body1 == target && body2 == player)) {
-                        list_remove(forces, i);
+                        scene_remove_force(scene, force);
                     }
                 }
 
@@ -802,54 +765,94 @@ void run_loading_screen() {
         count++;
     }
     scene_free(start_scene);
-    sdl_free();
     list_free(textboxes);
+    sdl_free();
 }
 
-// Assigns the appropriate textbox to be displayed in scene
-list_t *assign_textboxes(scene_t *scene, size_t current_level) {
+// The sets of textboxes the game shows
+typedef enum {
+    TEXT_MENU,
+    TEXT_WIN,
+    TEXT_LOSS,
+    TEXT_TUTORIAL,
+    TEXT_DEFAULT
+} text_screen_t;
+
+// Returns which set of textboxes should be displayed in scene
+text_screen_t get_text_screen(scene_t *scene, size_t current_level) {
     if (scene_show_text_image(scene, 0)) {
-        return make_menu_text();
+        return TEXT_MENU;
     }
     else if (scene_show_text_image(scene, 1)) {
-        return make_win_text();
+        return TEXT_WIN;
     }
     else if (scene_show_text_image(scene, 2)) {
-        return make_loss_text();
+        return TEXT_LOSS;
     }
     else if (current_level == 1) {
-        return make_tutorial();
+        return TEXT_TUTORIAL;
     }
     else {
-        return default_tbs();
+        return TEXT_DEFAULT;
+    }
+}
+
+// Makes the textboxes of a text screen
+list_t *make_textboxes(text_screen_t screen) {
+    switch (screen) {
+        case TEXT_MENU:
+            return make_menu_text();
+        case TEXT_WIN:
+            return make_win_text();
+        case TEXT_LOSS:
+            return make_loss_text();
+        case TEXT_TUTORIAL:
+            return make_tutorial();
+        default:
+            return default_tbs();
     }
 }
 
+// Frees a level's scene and textboxes, then the renderer.
+// The textboxes must go first because sdl_free() also shuts down SDL_ttf.
+void free_level(scene_t *scene, list_t *textboxes) {
+    list_free(textboxes);
+    scene_free(scene);
+    sdl_free();
+}
+
 int main(int argc, char *argv[]) {
     run_loading_screen();
     size_t current_level = STARTING_LEVEL;
     bool died = false;
-    list_t *textboxes;
     scene_t *scene = set_up_level(current_level);
+    // Textboxes are only rebuilt when the screen or level changes, so their text stays rendered
+    text_screen_t text_screen = get_text_screen(scene, current_level);
+    list_t *textboxes = make_textboxes(text_screen);
     sdl_on_key((key_handler_t) on_key);
-
-    while (!sdl_is_done(scene)) {
-        textboxes = assign_textboxes(scene, current_level);
-
+    stepper_t *stepper = stepper_init(PHYSICS_STEP, MAX_PHYSICS_STEPS);
+    frame_timer_t *timer = sdl_get_frame_timer();
+    size_t physics_phase = frame_timer_add_phase(timer, "physics");
+    size_t render_phase = frame_timer_add_phase(timer, "render");
+#ifdef PROFILE_FRAMES
+    double profile_time = 0;
+#endif
+
+    while (!sdl_is_done(scene) && !quit_game) {
         // Level Restart Condition: 'r' is clicked while the menu is pulled up
-        body_t *menu_button = scene_get_body(scene, find_body_in_scene(scene, 'R', scene_bodies(scene)));
+        body_t *menu_button = scene_get_tagged(scene, 'R');
         if (body_get_elasticity(menu_button) == 2) {
             body_set_elasticity(menu_button, 1);
-            scene_free(scene);
-            sdl_free();
+            free_level(scene, textboxes);
+            textboxes = NULL;
             scene = set_up_level(current_level);
         }
 
         // Win Condition: target is no longer there
-        else if (find_body_in_scene(scene, 'E', scene_bodies(scene)) == -1) {
+        else if (scene_get_tagged(scene, 'E') == NULL) {
             current_level++;
-            scene_free(scene);
-            sdl_free();
+            free_level(scene, textboxes);
+            textboxes = NULL;
             if (current_level > NUM_LEVELS) {
                 current_level = STARTING_LEVEL;
                 scene = set_up_level(current_level);
@@ -861,19 +864,47 @@ int main(int argc, char *argv[]) {
         }
 
         // Loss Condition: player is no longer there
-        else if (find_body_in_scene(scene, 'P', scene_bodies(scene)) == -1) {
+        else if (scene_get_tagged(scene, 'P') == NULL) {
             died = true;
-            scene_free(scene);
-            sdl_free();
+            free_level(scene, textboxes);
+            textboxes = NULL;
             scene = set_up_level(current_level);
             scene_set_show_text_image(scene, LOSS_IMAGE_INDEX, true);
         }
 
-        scene_tick(scene, time_since_last_tick());
+        if (textboxes == NULL) {
+            text_screen = get_text_screen(scene, current_level);
+            textboxes = make_textboxes(text_screen);
+        }
+        else if (get_text_screen(scene, current_level) != text_screen) {
+            // Build the new textboxes first so fonts they share with the old ones stay open
+            text_screen = get_text_screen(scene, current_level);
+            list_t *old_textboxes = textboxes;
+            textboxes = make_textboxes(text_screen);
+            list_free(old_textboxes);
+        }
+
+        double dt = time_since_last_tick();
+        frame_timer_start_phase(timer, physics_phase);
+        stepper_advance(stepper, scene, dt);
+        frame_timer_stop_phase(timer, physics_phase);
+        sdl_set_interpolation(stepper_get_alpha(stepper));
+        frame_timer_start_phase(timer, render_phase);
         sdl_render_scene(scene, textboxes);
-        list_free(textboxes);
+        frame_timer_stop_phase(timer, render_phase);
+#ifdef PROFILE_FRAMES
+        profile_time += dt;
+        if (profile_time >= PROFILE_INTERVAL) {
+            profile_time = 0;
+            printf("%.1f fps: physics %.2f ms, render %.2f ms, %zu draw calls\n",
+                   frame_timer_get_fps(timer),
+                   frame_timer_get_phase_time(timer, physics_phase) * 1000,
+                   frame_timer_get_phase_time(timer, render_phase) * 1000,
+                   sdl_get_draw_calls());
+        }
+#endif
     }
 
-    scene_free(scene);
-    sdl_free();
+    stepper_free(stepper);
+    free_level(scene, textboxes);
 }
@@ -0,0 +1,95 @@
+#ifndef __ANIMATION_H__
+#define __ANIMATION_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "image.h"
+
+/**
+ * A sequence of images, each shown for its own duration.
+ * Repeated frames are one entry with a longer duration rather than
+ * many copies of the same image.
+ */
+typedef struct animation animation_t;
+
+/**
+ * What an animation shows once its last frame has finished.
+ */
+typedef enum {
+    // Start again from the first frame
+    ANIMATION_LOOP,
+    // Keep showing the last frame
+    ANIMATION_ONCE,
+    // Play the frames backwards, then forwards again, and so on
+    ANIMATION_PING_PONG
+} animation_mode_t;
+
+/**
+ * Allocates memory for an animation with no frames.
+ * Asserts that the memory was allocated.
+ *
+ * @param mode what the animation does after its last frame
+ * @return a pointer to the newly allocated animation
+ */
+animation_t *animation_init(animation_mode_t mode);
+
+/**
+ * Allocates memory for an animation that always shows one image.
+ *
+ * @param image the image to show; the animation takes ownership of it
+ * @return a pointer to the newly allocated animation
+ */
+animation_t *animation_init_still(image_t *image);
+
+/**
+ * Releases the memory of an animation and its images.
+ *
+ * @param animation a pointer to an animation returned from animation_init()
+ */
+void animation_free(animation_t *animation);
+
+/**
+ * Appends a frame to the end of an animation.
+ *
+ * @param animation a pointer to an animation returned from animation_init()
+ * @param image the image to show; the animation takes ownership of it
+ * @param duration how long the frame is shown, in seconds; must be positive
+ */
+void animation_add_frame(animation_t *animation, image_t *image, double duration);
+
+/**
+ * Gets the number of frames in an animation.
+ *
+ * @param animation a pointer to an animation returned from animation_init()
+ * @return the number of frames
+ */
+size_t animation_num_frames(animation_t *animation);
+
+/**
+ * Gets the time it takes to play every frame of an animation once.
+ *
+ * @param animation a pointer to an animation returned from animation_init()
+ * @return the sum of the frames' durations, in seconds
+ */
+double animation_get_duration(animation_t *animation);
+
+/**
+ * Gets whether an animation ever changes the image it shows,
+ * i.e. whether it has more than one frame.
+ *
+ * @param animation a pointer to an animation returned from animation_init()
+ * @return whether the shown image depends on the playback time
+ */
+bool animation_is_animated(animation_t *animation);
+
+/**
+ * Gets the image an animation shows after playing for some time.
+ * The animation must have at least one frame.
+ *
+ * @param animation a pointer to an animation returned from animation_init()
+ * @param time the time since the animation started, in seconds
+ * @return the image to show, owned by the animation
+ */
+image_t *animation_get_frame(animation_t *animation, double time);
+
+#endif // #ifndef __ANIMATION_H__
@@ -6,6 +6,8 @@
 #include "list.h"
 #include "vector.h"
 #include "image.h"
+#include "animation.h"
+#include "polygon.h"
 
 /**
  * A rigid body constrained to the plane.
@@ -15,6 +17,18 @@
  */
 typedef struct body body_t;
 
+/**
+ * How a scene treats a body each tick.
+ * Dynamic bodies are integrated by body_tick(). Static bodies have infinite
+ * mass and no motion, so ticking them would do nothing, and sleeping bodies
+ * have been at rest long enough that they are left alone until woken.
+ */
+typedef enum {
+    BODY_DYNAMIC,
+    BODY_STATIC,
+    BODY_SLEEPING
+} body_motion_t;
+
 /**
  * Initializes a body without any info.
  * Acts like body_init_with_info() where info and info_freer are NULL.
@@ -26,7 +40,8 @@ body_t *body_init(list_t *shape, double mass, rgb_color_t color);
  * The body is initially at rest.
  * Asserts that the mass is positive and that the required memory is allocated.
  *
- * @param shape a list of vectors describing the initial shape of the body
+ * @param shape a list of vectors describing the initial shape of the body.
+ *   The body copies the vertices and frees the list.
  * @param mass the mass of the body (if INFINITY, stops the body from moving)
  * @param color the color of the body, used to draw it on the screen
  * @param info additional information to associate with the body,
@@ -42,6 +57,47 @@ body_t *body_init_with_info(
     free_func_t info_freer
 );
 
+/**
+ * Allocates memory for a circular body.
+ * Collisions with circles are computed exactly instead of from a polygon,
+ * but the body still has a regular polygon approximating the circle
+ * for functions like body_get_shape() that need vertices.
+ * Asserts that the radius and mass are positive.
+ *
+ * @param center the center of the circle, which is also its centroid
+ * @param radius the radius of the circle
+ * @param mass the mass of the body (if INFINITY, stops the body from moving)
+ * @param color the color of the body, used to draw it on the screen
+ * @param info additional information to associate with the body
+ * @param info_freer if non-NULL, a function call on the info to free it
+ * @return a pointer to the newly allocated body
+ */
+body_t *body_init_circle(
+    vector_t center,
+    double radius,
+    double mass,
+    rgb_color_t color,
+    void *info,
+    free_func_t info_freer
+);
+
+/**
+ * Returns whether a body was created by body_init_circle().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return true if the body is a circle, false if it is a polygon
+ */
+bool body_is_circle(body_t *body);
+
+/**
+ * Gets the radius of a circular body.
+ * Asserts that the body is a circle.
+ *
+ * @param body a pointer to a body returned from body_init_circle()
+ * @return the radius of the circle
+ */
+double body_get_radius(body_t *body);
+
 /**
  * Releases the memory allocated for a body.
  *
@@ -52,12 +108,60 @@ void body_free(body_t *body);
 /**
  * Gets the current shape of a body.
  * Returns a newly allocated vector list, which must be list_free()d.
+ * Prefer body_get_shape_view() unless the caller needs to own the vertices.
  *
  * @param body a pointer to a body returned from body_init()
  * @return the polygon describing the body's current position
  */
 list_t *body_get_shape(body_t *body);
 
+/**
+ * Gets a borrowed, read-only view of the current shape of a body.
+ * Does not copy or allocate; the view is invalidated by any call that moves
+ * or rotates the body (e.g. body_set_centroid() or body_tick()).
+ * Bodies store their shape relative to their centroid, and the vertices
+ * in the plane are only recomputed here (or by body_get_shape()) after
+ * the body has moved or rotated.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the vertices describing the body's current position
+ */
+polygon_view_t body_get_shape_view(body_t *body);
+
+/**
+ * Gets the number of vertices in a body's shape.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the number of vertices
+ */
+size_t body_get_num_vertices(body_t *body);
+
+/**
+ * Gets where a body's centroid was partway through its last tick.
+ * Renderers use this to draw smooth motion when physics runs
+ * at a different rate than frames are drawn.
+ * Setting the centroid outside of a tick (e.g. body_set_centroid())
+ * makes the body jump there rather than move smoothly.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param alpha how far through the last tick, from 0 (its start) to 1 (its end)
+ * @return the interpolated centroid
+ */
+vector_t body_get_interpolated_centroid(body_t *body, double alpha);
+
+/**
+ * Gets a view of a body's shape partway through its last tick,
+ * with both its centroid and rotation interpolated.
+ * Bodies that did not move are returned as body_get_shape_view() without copying;
+ * otherwise the vertices are written to buffer.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param alpha how far through the last tick, from 0 (its start) to 1 (its end)
+ * @param buffer space for body_get_num_vertices() vertices
+ * @return the vertices describing the body's interpolated position
+ */
+polygon_view_t body_get_interpolated_shape(body_t *body, double alpha, vector_t *buffer);
+
 /**
  * Gets the current center of mass of a body.
  * While this could be calculated with polygon_centroid(), that becomes too slow
@@ -69,6 +173,35 @@ list_t *body_get_shape(body_t *body);
  */
 vector_t body_get_centroid(body_t *body);
 
+/**
+ * Gets the smallest axis-aligned box containing the body's current shape.
+ * The box is cached on the body: moving an unrotated body just moves its box,
+ * and only a rotated body's box is recomputed from its vertices, lazily.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the bounding box of the body
+ */
+bounding_box_t body_get_bounding_box(body_t *body);
+
+/**
+ * Gets how far a body moved during its last tick.
+ * Setting its centroid outside of a tick (e.g. body_set_centroid())
+ * counts as not moving.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the displacement of the body's centroid over its last tick
+ */
+vector_t body_get_last_motion(body_t *body);
+
+/**
+ * Gets the smallest axis-aligned box containing everywhere the body's
+ * current shape was during its last tick, ignoring rotation.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the bounding box of the body's path
+ */
+bounding_box_t body_get_swept_bounding_box(body_t *body);
+
 /**
  * Gets the current velocity of a body.
  *
@@ -102,14 +235,50 @@ rgb_color_t body_get_color(body_t *body);
 void *body_get_info(body_t *body);
 
 /**
- * Adds an image_list to body to rotate through every body tick
+ * The tag of a body that has not been given one with body_set_tag().
+ */
+#define BODY_NO_TAG '\0'
+
+/**
+ * Labels a body with a one-character kind, e.g. 'W' for walls.
+ * Scenes index their bodies by tag so they can be found without a search;
+ * see scene_get_tagged(). The tag must be set before the body is added
+ * to a scene, and not changed afterwards.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param tag the body's kind
+ */
+void body_set_tag(body_t *body, char tag);
+
+/**
+ * Gets the tag set with body_set_tag().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's tag, or BODY_NO_TAG if it does not have one
+ */
+char body_get_tag(body_t *body);
+
+/**
+ * Gets the force creators that act on a body, i.e. those whose bodies list
+ * includes it. The list is kept up to date by the scene containing the body
+ * so that removing the body only has to visit its own force creators.
+ * The elements are the scene's force_t pointers; the list must not be freed.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the list of force creators acting on the body
+ */
+list_t *body_get_force_creators(body_t *body);
+
+/**
+ * Sets the animation drawn over body and plays it from the start as the body ticks.
+ * The body takes ownership of the animation and frees any previous one.
  */ 
-void body_add_image_list(body_t *body, list_t *image_list);
+void body_set_animation(body_t *body, animation_t *animation);
 
 /**
- * Returns true if a body has an image list, false otherwise
+ * Returns true if a body has an animation to draw, false otherwise
  */ 
-bool body_has_image_list(body_t *body);
+bool body_has_image(body_t *body);
 
 /**
  * Returns the current image to be displayed for a body
@@ -119,6 +288,7 @@ image_t *body_get_current_image(body_t *body);
 /**
  * Translates a body to a new position.
  * The position is specified by the position of the body's center of mass.
+ * Wakes the body if it is static or asleep, so that its scene sees it move.
  *
  * @param body a pointer to a body returned from body_init()
  * @param x the body's new centroid
@@ -145,6 +315,7 @@ void body_set_passive_rotation(body_t *body, double new_passive_rotation);
  * Changes a body's orientation in the plane.
  * The body is rotated about its center of mass.
  * Note that the angle is *absolute*, not relative to the current orientation.
+ * Wakes the body if it is static or asleep, so that its scene sees it turn.
  *
  * @param body a pointer to a body returned from body_init()
  * @param angle the body's new angle in radians. Positive is counterclockwise.
@@ -186,6 +357,39 @@ void body_add_impulse(body_t *body, vector_t impulse);
  */
 void body_tick(body_t *body, double dt);
 
+/**
+ * Ticks a range of the bodies in a list, exactly as body_tick() would.
+ * The bodies' velocities, forces and masses are copied into arrays
+ * a block at a time, so the integration itself is one tight loop.
+ * Removed bodies are skipped. Bodies in the range must be distinct,
+ * so disjoint ranges of a list can be ticked on different threads.
+ *
+ * @param bodies a list of bodies
+ * @param start the index of the first body to tick
+ * @param end one past the index of the last body to tick
+ * @param dt the number of seconds elapsed since the last tick
+ */
+void body_tick_list(list_t *bodies, size_t start, size_t end, double dt);
+
+/**
+ * Sets whether a body is a bullet. Collision force creators test bullets
+ * against the whole path they moved along during their last tick,
+ * so fast or small bodies cannot pass through thin ones between ticks.
+ * This is more expensive, so only fast bodies should be bullets.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param bullet whether the body is a bullet
+ */
+void body_set_bullet(body_t *body, bool bullet);
+
+/**
+ * Gets whether a body is a bullet; see body_set_bullet().
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return whether the body is a bullet
+ */
+bool body_is_bullet(body_t *body);
+
 /**
  * Marks a body for removal--future calls to body_is_removed() will return true.
  * Does not free the body.
@@ -227,10 +431,95 @@ double body_get_elasticity(body_t *body);
  * Redefines a body's centroid but DOES NOT UPDATE ITS POSITION. Used
  * when we want to manually set a body to have a centroid that is not the
  * center of all its points.
+ * A circle given a new centroid is treated as its polygon from then on.
  *
  * @param body a pointer to a body returned from body_init()
  * @param x the centroid we want to use for body going forward
  */
 void body_redefine_centroid(body_t *body, vector_t new_centroid);
 
+/**
+ * Gets whether a body is dynamic, static or sleeping.
+ * New bodies are dynamic until a scene classifies them.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's current motion state
+ */
+body_motion_t body_get_motion(body_t *body);
+
+/**
+ * Decides which motion state a body should be in after it was ticked.
+ * Counts how many consecutive ticks the body has been at rest,
+ * so it should be called exactly once per tick for dynamic bodies.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return BODY_STATIC if ticking the body cannot change it,
+ *   BODY_SLEEPING if it has been nearly still, with no forces or impulses
+ *   applied, for long enough,
+ *   and BODY_DYNAMIC otherwise
+ */
+body_motion_t body_classify(body_t *body);
+
+/**
+ * Moves a body out of the dynamic state. Sleeping bodies lose their
+ * remaining velocity. Once woken, the body appends itself to wake_list
+ * so its owner can start ticking it again.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param motion BODY_STATIC or BODY_SLEEPING
+ * @param wake_list the list to add the body to when it wakes, or NULL
+ */
+void body_deactivate(body_t *body, body_motion_t motion, list_t *wake_list);
+
+/**
+ * Makes a static or sleeping body dynamic again. Called automatically when
+ * the body is given a velocity, passive rotation, animation, or a force or
+ * impulse that can move it. Does nothing to a dynamic body.
+ *
+ * @param body a pointer to a body returned from body_init()
+ */
+void body_wake(body_t *body);
+
+/**
+ * A list of forces and impulses whose application has been put off,
+ * so that several threads can compute forces at once without writing
+ * to the same bodies. See body_force_buffer_capture().
+ */
+typedef struct body_force_buffer body_force_buffer_t;
+
+/**
+ * Allocates memory for an empty force buffer.
+ * Asserts that the required memory was allocated.
+ *
+ * @return a pointer to the newly allocated force buffer
+ */
+body_force_buffer_t *body_force_buffer_init(void);
+
+/**
+ * Releases the memory allocated for a force buffer,
+ * dropping any forces it still holds.
+ *
+ * @param buffer a pointer to a force buffer returned from body_force_buffer_init()
+ */
+void body_force_buffer_free(body_force_buffer_t *buffer);
+
+/**
+ * Makes body_add_force() and body_add_impulse() on the calling thread
+ * append to a buffer instead of changing the body, until this is called
+ * again with NULL. Other threads are not affected.
+ *
+ * @param buffer a pointer to a force buffer returned from body_force_buffer_init(),
+ *   or NULL to stop capturing
+ */
+void body_force_buffer_capture(body_force_buffer_t *buffer);
+
+/**
+ * Applies every force and impulse in a buffer to its body,
+ * in the order they were added, and empties the buffer.
+ * Must not be called while the calling thread is capturing.
+ *
+ * @param buffer a pointer to a force buffer returned from body_force_buffer_init()
+ */
+void body_force_buffer_apply(body_force_buffer_t *buffer);
+
 #endif // #ifndef __BODY_H__
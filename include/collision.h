@@ -2,6 +2,8 @@
 #define __COLLISION_H__
 
 #include <stdbool.h>
+#include <stddef.h>
+#include "body.h"
 #include "list.h"
 #include "vector.h"
 
@@ -21,6 +23,43 @@ typedef struct {
     vector_t axis;
 } collision_info_t;
 
+/**
+ * Represents where along a motion one shape first hits another.
+ */
+typedef struct {
+    /** Whether the shapes touch at some point during the motion */
+    bool collided;
+    /**
+     * If the shapes collide, the fraction of the motion completed when they
+     * first touch, from 0 (already overlapping at the start) to 1.
+     * If collided is false, this value is undefined.
+     */
+    double time;
+    /**
+     * If the shapes collide, the axis they first touch on:
+     * a unit vector pointing from the first shape towards the second.
+     * If collided is false, this value is undefined.
+     */
+    vector_t axis;
+} sweep_info_t;
+
+/**
+ * Represents where a ray first hits a shape.
+ */
+typedef struct {
+    /** Whether the ray hits the shape within its maximum length */
+    bool hit;
+    /**
+     * If the ray hits, how far along the ray the hit is.
+     * If hit is false, this value is undefined.
+     */
+    double distance;
+    /** If the ray hits, the point where it enters the shape */
+    vector_t point;
+    /** If the ray hits, the unit normal of the shape's surface at point, facing out */
+    vector_t normal;
+} ray_hit_t;
+
 /**
  * Computes the status of the collision between two convex polygons.
  * The shapes are given as lists of vertices in counterclockwise order.
@@ -34,4 +73,156 @@ typedef struct {
  */
 collision_info_t find_collision(list_t *shape1, list_t *shape2);
 
+/**
+ * Computes the status of the collision between two convex polygons
+ * whose vertices are stored contiguously.
+ * Behaves exactly like find_collision(), but performs no heap allocations.
+ *
+ * @param shape1 the vertices of the first shape, in counterclockwise order
+ * @param size1 the number of vertices in shape1
+ * @param shape2 the vertices of the second shape, in counterclockwise order
+ * @param size2 the number of vertices in shape2
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ */
+collision_info_t find_collision_points(
+    const vector_t *shape1,
+    size_t size1,
+    const vector_t *shape2,
+    size_t size2
+);
+
+/**
+ * Computes the status of the collision between two circles.
+ * Circles that only touch are not considered colliding.
+ *
+ * @param center1 the center of the first circle
+ * @param radius1 the radius of the first circle
+ * @param center2 the center of the second circle
+ * @param radius2 the radius of the second circle
+ * @return whether the circles are colliding, and if so, the collision axis,
+ * a unit vector from center1 towards center2.
+ */
+collision_info_t find_circle_collision(
+    vector_t center1,
+    double radius1,
+    vector_t center2,
+    double radius2
+);
+
+/**
+ * Computes the status of the collision between a circle and a polygon
+ * whose vertices are stored contiguously, using the point on the polygon's
+ * boundary nearest the circle's center.
+ *
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @param points the vertices of the polygon
+ * @param size the number of vertices in the polygon
+ * @return whether the shapes are colliding, and if so, the collision axis,
+ * a unit vector pointing from the circle towards the polygon.
+ */
+collision_info_t find_circle_polygon_collision(
+    vector_t center,
+    double radius,
+    const vector_t *points,
+    size_t size
+);
+
+/**
+ * Finds when a convex polygon moving in a straight line first hits
+ * a stationary one (a swept separating axis test). Unlike testing the end
+ * of the motion with find_collision_points(), this finds hits however thin
+ * the second shape is and however far the first one moves.
+ * Shapes that only touch are not considered colliding.
+ *
+ * @param shape1 the vertices of the moving shape at the start of the motion
+ * @param size1 the number of vertices in shape1
+ * @param motion how far shape1 moves
+ * @param shape2 the vertices of the stationary shape
+ * @param size2 the number of vertices in shape2
+ * @return whether the shapes collide during the motion, and if so, when and on what axis
+ */
+sweep_info_t find_swept_collision_points(
+    const vector_t *shape1,
+    size_t size1,
+    vector_t motion,
+    const vector_t *shape2,
+    size_t size2
+);
+
+/**
+ * Finds when two bodies first touched during their last tick,
+ * assuming each moved in a straight line without rotating
+ * (see body_get_last_motion()). Circles are swept as their polygons.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @return whether the bodies collided during their last tick,
+ *   and if so, when and on what axis
+ */
+sweep_info_t find_body_sweep(body_t *body1, body_t *body2);
+
+/**
+ * Finds where a ray first enters a convex polygon.
+ * Polygons that contain the ray's origin are not hit,
+ * so a ray cast from inside a body passes out of it.
+ *
+ * @param origin the start of the ray
+ * @param direction the unit vector the ray points along
+ * @param max_length how far the ray reaches
+ * @param points the vertices of the polygon, in either order
+ * @param size the number of vertices in the polygon
+ * @return whether the ray hits the polygon, and if so, where
+ */
+ray_hit_t find_ray_polygon_hit(
+    vector_t origin,
+    vector_t direction,
+    double max_length,
+    const vector_t *points,
+    size_t size
+);
+
+/**
+ * Finds where a ray first enters a circle.
+ * Circles that contain the ray's origin are not hit.
+ *
+ * @param origin the start of the ray
+ * @param direction the unit vector the ray points along
+ * @param max_length how far the ray reaches
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @return whether the ray hits the circle, and if so, where
+ */
+ray_hit_t find_ray_circle_hit(
+    vector_t origin,
+    vector_t direction,
+    double max_length,
+    vector_t center,
+    double radius
+);
+
+/**
+ * Finds where a ray first enters the current shape of a body.
+ * Circles made with body_init_circle() are tested exactly, without their vertices.
+ *
+ * @param origin the start of the ray
+ * @param direction the unit vector the ray points along
+ * @param max_length how far the ray reaches
+ * @param body the body to test
+ * @return whether the ray hits the body, and if so, where
+ */
+ray_hit_t find_ray_body_hit(vector_t origin, vector_t direction, double max_length, body_t *body);
+
+/**
+ * Computes the status of the collision between the current shapes of
+ * two bodies. Reads the bodies' vertices in place instead of copying them
+ * with body_get_shape(). Circles made with body_init_circle() are tested
+ * exactly, without their vertices.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @return whether the bodies are colliding, and if so, the collision axis.
+ */
+collision_info_t find_body_collision(body_t *body1, body_t *body2);
+
 #endif // #ifndef __COLLISION_H__
@@ -39,7 +39,20 @@ void create_universal_gravity(scene_t *scene, double G, body_t *body, void *extr
 typedef void (*collision_handler_t)
     (body_t *body1, body_t *body2, vector_t axis, void *aux);
 
-
+/**
+ * Adds a force creator to a scene that calls handler on two bodies every tick,
+ * whether or not they are colliding.
+ * The axis passed to handler is the collision axis when the bodies' bounding
+ * boxes overlap, and otherwise the unit vector from body1's centroid
+ * towards body2's.
+ *
+ * @param scene the scene containing the bodies
+ * @param body1 the first body
+ * @param body2 the second body
+ * @param handler a function to call every tick
+ * @param aux an auxiliary value to pass to the handler
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
 void create_interaction(
     scene_t *scene,
     body_t *body1,
@@ -66,6 +79,23 @@ void calc_interaction(aux_t *aux);
  */
 void create_newtonian_gravity(scene_t *scene, double G, body_t *body1, body_t *body2);
 
+/**
+ * Adds a single force creator to a scene that applies Newtonian gravity
+ * between every pair of bodies with a given tag.
+ * This replaces calling create_newtonian_gravity() on every pair:
+ * the bodies' positions and masses are gathered into flat arrays each tick
+ * and all of the forces are computed in one pass.
+ * Bodies added with the tag later are included, and removed bodies are
+ * dropped, without recreating the force.
+ *
+ * @param scene the scene containing the bodies
+ * @param G the gravitational proportionality constant
+ * @param tag the tag of the bodies to attract each other
+ * @param theta 0 to compute every pair exactly, or the Barnes-Hut opening
+ *   angle (e.g. 0.5) to approximate far groups of bodies for large scenes
+ */
+void create_nbody_gravity(scene_t *scene, double G, char tag, double theta);
+
 /**
  * Adds a force creator to a scene that acts like a spring between two bodies.
  * The force creator will be called each tick
@@ -92,6 +122,21 @@ void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2);
  */
 void create_drag(scene_t *scene, double gamma, body_t *body);
 
+/**
+ * Tests the two bodies in aux for a collision and stores the result
+ * with aux_set_contact(). Only reads the bodies, so it is safe to run
+ * at the same time as other detectors.
+ *
+ * @param aux an aux created by create_collision()
+ */
+void detect_collision(aux_t *aux);
+
+/**
+ * Calls the collision handler in aux when the contact stored by
+ * detect_collision() starts a collision.
+ *
+ * @param aux an aux created by create_collision()
+ */
 void calc_collision(aux_t *aux);
 
 /**
@@ -0,0 +1,117 @@
+#ifndef __FRAME_TIMER_H__
+#define __FRAME_TIMER_H__
+
+#include <stddef.h>
+
+/**
+ * Measures how long frames, and named phases within them, take.
+ * All times come from a monotonic wall clock, so they include time
+ * spent waiting (e.g. for vsync) and never jump when the system clock is set.
+ * Frame rates and phase times are smoothed over recent frames
+ * so they can be displayed or logged without flickering.
+ */
+typedef struct frame_timer frame_timer_t;
+
+/**
+ * Gets the current time of a monotonic, high-resolution clock.
+ * Only differences between two readings are meaningful.
+ *
+ * @return the current time, in seconds
+ */
+double frame_timer_now(void);
+
+/**
+ * Allocates memory for a frame timer with no phases.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @return a pointer to the newly allocated frame timer
+ */
+frame_timer_t *frame_timer_init(void);
+
+/**
+ * Releases the memory allocated for a frame timer.
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ */
+void frame_timer_free(frame_timer_t *timer);
+
+/**
+ * Marks the start of a new frame.
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ * @return the time since the previous call, in seconds,
+ *   or 0 the first time this is called
+ */
+double frame_timer_tick(frame_timer_t *timer);
+
+/**
+ * Gets the length of the last frame, as returned by the last frame_timer_tick().
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ * @return the length of the last frame, in seconds
+ */
+double frame_timer_get_dt(frame_timer_t *timer);
+
+/**
+ * Gets the smoothed number of frames per second.
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ * @return the frame rate, or 0 before two frames have been timed
+ */
+double frame_timer_get_fps(frame_timer_t *timer);
+
+/**
+ * Adds a phase to time within each frame, e.g. "physics" or "render".
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ * @param name the name of the phase, which must outlive the timer
+ * @return the index of the phase, to pass to the other phase functions
+ */
+size_t frame_timer_add_phase(frame_timer_t *timer, const char *name);
+
+/**
+ * Gets the number of phases added to a frame timer.
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ * @return the number of phases
+ */
+size_t frame_timer_num_phases(frame_timer_t *timer);
+
+/**
+ * Gets the name a phase was added with.
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ * @param phase the index of the phase
+ * @return the name of the phase
+ */
+const char *frame_timer_get_phase_name(frame_timer_t *timer, size_t phase);
+
+/**
+ * Starts timing a phase.
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ * @param phase the index of the phase
+ */
+void frame_timer_start_phase(frame_timer_t *timer, size_t phase);
+
+/**
+ * Stops timing a phase started with frame_timer_start_phase().
+ * A phase may be started and stopped several times in a frame;
+ * its time for the frame is the total.
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ * @param phase the index of the phase
+ */
+void frame_timer_stop_phase(frame_timer_t *timer, size_t phase);
+
+/**
+ * Gets the smoothed time a phase took per frame, over the frames
+ * finished by frame_timer_tick().
+ *
+ * @param timer a pointer to a frame timer returned from frame_timer_init()
+ * @param phase the index of the phase
+ * @return the time of the phase, in seconds
+ */
+double frame_timer_get_phase_time(frame_timer_t *timer, size_t phase);
+
+#endif // #ifndef __FRAME_TIMER_H__
@@ -11,8 +11,10 @@
 typedef struct image image_t;
 
 /**
-* Initializes and returns a pointer to an image_t with an SDL surface created
-* with the image at name and the dimensions in dimensions. Frees the memory at name.
+* Initializes and returns a pointer to an image_t showing the image at name
+* with the dimensions in dimensions. Each file is decoded once and shared by
+* every image_t made from the same name until the last of them is freed.
+* Does not take ownership of name.
 * 
 * @param name the name of the image
 * @param dimensions the dimensions of the image
@@ -26,6 +28,28 @@ image_t *image_init(char *name, vector_t dimensions, double rotation);
 */
 SDL_Surface *image_get_surface(image_t *image);
 
+/**
+* Returns a texture of image for renderer, uploading the surface the first time
+* it is drawn and reusing the texture on later frames. The texture is shared by
+* every image of the same file and freed with the last of them.
+*
+* @param image the image to draw
+* @param renderer the renderer to draw it with
+* @return the texture of the image
+*/
+SDL_Texture *image_get_texture(image_t *image, SDL_Renderer *renderer);
+
+/**
+* Forgets every texture made by image_get_texture(), so the next call makes a new one.
+* Must be called when the renderer is destroyed, which destroys its textures.
+*/
+void image_invalidate_textures(void);
+
+/**
+* Returns the number of distinct image files currently decoded
+*/
+size_t image_num_assets(void);
+
 /**
 * Returns the dimensions of an image
 */
@@ -47,7 +71,8 @@ void image_set_show(image_t *image, bool new_value);
 bool image_get_show(image_t *image);
 
 /**
-* Frees the memory associated with image
+* Frees the memory associated with image, and its decoded file if no other
+* image uses it
 */
 void image_free(image_t *image);
 
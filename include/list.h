@@ -1,6 +1,7 @@
 #ifndef __LIST_H__
 #define __LIST_H__
 
+#include <stdbool.h>
 #include <stddef.h>
 
 /**
@@ -63,6 +64,17 @@ size_t list_size(list_t *list);
  */
 void *list_get(list_t *list, size_t index);
 
+/**
+ * Replaces the element at a given index in a list.
+ * Does not free the element being replaced.
+ * Asserts that the index is valid and that the new value is non-NULL.
+ *
+ * @param list a pointer to a list returned from list_init()
+ * @param index an index in the list (the first element is at 0)
+ * @param value the element to store at the given index
+ */
+void list_set(list_t *list, size_t index, void *value);
+
 /**
  * Appends an element to the end of a list.
  * If the list is filled to capacity, resizes the list to fit more elements
@@ -98,6 +110,26 @@ void list_add_front(list_t *list, void *item);
  */
 void list_add_back(list_t *list, void *item);
 
+/**
+ * A function that decides whether to remove an element of a list.
+ * Takes the element and an auxiliary value passed to list_remove_if().
+ */
+typedef bool (*list_predicate_t)(void *item, void *aux);
+
+/**
+ * Removes every element of a list for which should_remove returns true,
+ * keeping the remaining elements in their original order.
+ * Removed elements are freed with the list's freer, if it has one.
+ * Unlike calling list_remove() for each element, this takes a single pass,
+ * so it costs O(n) no matter how many elements are removed.
+ *
+ * @param list a pointer to a list returned from list_init()
+ * @param should_remove called once on each element, in order
+ * @param aux an auxiliary value to pass to should_remove
+ * @return the number of elements removed
+ */
+size_t list_remove_if(list_t *list, list_predicate_t should_remove, void *aux);
+
 /**
  * Removes the element at the back of the list and returns it
  * Asserts the index is valid
@@ -3,6 +3,7 @@
 
 
 #include "body.h"
+#include "collision.h"
 
 /**
  * A structure that holds the force constant,
@@ -95,5 +96,42 @@ void aux_set_aux_info(aux_t *aux, void *info);
  */ 
 void aux_set_collided_last_frame(aux_t *aux, bool new_val);
 
+/**
+ * Gets the result of the last collision test between the bodies in aux.
+ *
+ * @param aux a pointer to an aux returned from aux_init()
+ * @return the collision info stored by aux_set_contact(),
+ *   or no collision if none was stored
+ */
+collision_info_t aux_get_contact(aux_t *aux);
+
+/**
+ * Stores the result of a collision test between the bodies in aux,
+ * so detection and the collision handler can run at different times.
+ * Resets the contact time to 1, the end of the last tick.
+ *
+ * @param aux a pointer to an aux returned from aux_init()
+ * @param contact the collision info to store
+ */
+void aux_set_contact(aux_t *aux, collision_info_t contact);
+
+/**
+ * Gets when during the last tick the stored contact began.
+ *
+ * @param aux a pointer to an aux returned from aux_init()
+ * @return the fraction of the last tick before the bodies touched,
+ *   or 1 if the contact was found where the bodies are now
+ */
+double aux_get_contact_time(aux_t *aux);
+
+/**
+ * Records that the stored contact began partway through the last tick,
+ * as found by a swept test. Must be called after aux_set_contact().
+ *
+ * @param aux a pointer to an aux returned from aux_init()
+ * @param time the fraction of the last tick before the bodies touched
+ */
+void aux_set_contact_time(aux_t *aux, double time);
+
 
 #endif
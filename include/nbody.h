@@ -0,0 +1,69 @@
+#ifndef __NBODY_H__
+#define __NBODY_H__
+
+#include <stddef.h>
+
+/**
+ * Gravity kernels over a set of point masses stored as parallel arrays
+ * (x[i], y[i], mass[i]), so the inner loops touch contiguous memory
+ * instead of chasing body_t pointers.
+ * Pairs closer than min_distance exert no force on each other,
+ * since the force blows up as the distance goes to 0.
+ */
+
+/**
+ * Computes the exact Newtonian gravitational force on every point
+ * by visiting each pair once and applying equal and opposite forces.
+ * The forces are added to fx and fy, which must hold n values.
+ *
+ * @param n the number of points
+ * @param x the x-coordinates of the points
+ * @param y the y-coordinates of the points
+ * @param mass the masses of the points
+ * @param G the gravitational proportionality constant
+ * @param min_distance the distance below which a pair is ignored
+ * @param fx the x-components of the forces to add to
+ * @param fy the y-components of the forces to add to
+ */
+void nbody_pairwise_forces(
+    size_t n,
+    const double *x,
+    const double *y,
+    const double *mass,
+    double G,
+    double min_distance,
+    double *fx,
+    double *fy
+);
+
+/**
+ * Approximates the gravitational force on every point with a Barnes-Hut
+ * quadtree, which costs O(n log n) instead of O(n^2).
+ * A group of points is treated as a single mass at its center of mass
+ * when its width divided by its distance is below theta;
+ * theta = 0 visits every point and larger values trade accuracy for speed
+ * (0.5 is typical). The forces are added to fx and fy.
+ *
+ * @param n the number of points
+ * @param x the x-coordinates of the points
+ * @param y the y-coordinates of the points
+ * @param mass the masses of the points
+ * @param G the gravitational proportionality constant
+ * @param min_distance the distance below which a pair is ignored
+ * @param theta the opening angle of the approximation
+ * @param fx the x-components of the forces to add to
+ * @param fy the y-components of the forces to add to
+ */
+void nbody_barnes_hut_forces(
+    size_t n,
+    const double *x,
+    const double *y,
+    const double *mass,
+    double G,
+    double min_distance,
+    double theta,
+    double *fx,
+    double *fy
+);
+
+#endif // #ifndef __NBODY_H__
@@ -1,9 +1,28 @@
 #ifndef __POLYGON_H__
 #define __POLYGON_H__
 
+#include <stdbool.h>
 #include "list.h"
 #include "vector.h"
 
+/**
+ * An axis-aligned bounding box, given by its bottom left and top right corners.
+ */
+typedef struct {
+    vector_t min;
+    vector_t max;
+} bounding_box_t;
+
+/**
+ * A borrowed, read-only view of a polygon whose vertices are stored
+ * contiguously, e.g. the shape of a body_t.
+ * The view does not own the vertices, so it must not be freed,
+ * and it is only valid until the owner of the vertices changes them.
+ */
+typedef struct {
+    const vector_t *points;
+    size_t size;
+} polygon_view_t;
 
 /**
  * Computes the area of a polygon.
@@ -47,4 +66,144 @@ void polygon_translate(list_t *polygon, vector_t translation);
  */
 void polygon_rotate(list_t *polygon, double angle, vector_t point);
 
+/**
+ * Computes the smallest axis-aligned box containing every vertex of a polygon.
+ *
+ * @param polygon the list of vertices that make up the polygon
+ * @return the bounding box of the polygon
+ */
+bounding_box_t polygon_bounding_box(list_t *polygon);
+
+/**
+ * Computes the smallest axis-aligned box containing every vertex of a polygon
+ * whose vertices are stored contiguously.
+ *
+ * @param points the vertices of the polygon
+ * @param size the number of vertices, which must be positive
+ * @return the bounding box of the polygon
+ */
+bounding_box_t polygon_points_bounding_box(const vector_t *points, size_t size);
+
+/**
+ * Computes the area of a polygon whose vertices are stored contiguously.
+ *
+ * @param points the vertices of the polygon, listed in a counterclockwise direction
+ * @param size the number of vertices
+ * @return the area of the polygon
+ */
+double polygon_points_area(const vector_t *points, size_t size);
+
+/**
+ * Computes the center of mass of a polygon whose vertices are stored contiguously.
+ *
+ * @param points the vertices of the polygon, listed in a counterclockwise direction
+ * @param size the number of vertices
+ * @return the centroid of the polygon
+ */
+vector_t polygon_points_centroid(const vector_t *points, size_t size);
+
+/**
+ * The implementations used by polygon_points_translate(),
+ * polygon_points_transform() and polygon_points_project(),
+ * from slowest to fastest. All of them give identical results.
+ */
+typedef enum {
+    POLYGON_KERNELS_SCALAR,
+    // x86-64 only; one vertex per instruction
+    POLYGON_KERNELS_SSE2,
+    // x86-64 CPUs with AVX; two vertices per instruction
+    POLYGON_KERNELS_AVX
+} polygon_kernels_t;
+
+/**
+ * Chooses the implementation of the contiguous polygon kernels.
+ * By default the fastest one the CPU supports is used,
+ * so this is only needed to compare them, e.g. in tests and benchmarks.
+ * Must not be called while other threads use the kernels.
+ *
+ * @param requested the kernels to use
+ * @return the kernels now in use: requested, or the fastest supported
+ *   kernels if the CPU does not support requested
+ */
+polygon_kernels_t polygon_set_kernels(polygon_kernels_t requested);
+
+/**
+ * Gets the implementation of the contiguous polygon kernels in use.
+ *
+ * @return the kernels in use
+ */
+polygon_kernels_t polygon_get_kernels(void);
+
+/**
+ * Translates every vertex of a contiguously stored polygon by a given vector.
+ * Note: mutates the original vertices.
+ *
+ * @param points the vertices of the polygon
+ * @param size the number of vertices
+ * @param translation the vector to add to each vertex's position
+ */
+void polygon_points_translate(vector_t *points, size_t size, vector_t translation);
+
+/**
+ * Rotates every vertex of a contiguously stored polygon by a given angle
+ * about a given point.
+ * Note: mutates the original vertices.
+ *
+ * @param points the vertices of the polygon
+ * @param size the number of vertices
+ * @param angle the angle to rotate the polygon, in radians.
+ * A positive angle means counterclockwise.
+ * @param point the point to rotate around
+ */
+void polygon_points_rotate(vector_t *points, size_t size, double angle, vector_t point);
+
+/**
+ * Places a polygon given relative to the origin into the plane,
+ * rotating it about the origin and then translating it.
+ * Writes the result to a separate array, leaving the original vertices alone.
+ *
+ * @param local the vertices of the polygon, relative to the origin
+ * @param world the array to write the placed vertices to; may not overlap local
+ * @param size the number of vertices
+ * @param position the point the origin is moved to
+ * @param angle the angle to rotate the polygon by, in radians.
+ * A positive angle means counterclockwise.
+ */
+void polygon_points_transform(
+    const vector_t *local,
+    vector_t *world,
+    size_t size,
+    vector_t position,
+    double angle
+);
+
+/**
+ * Projects every vertex of a contiguously stored polygon onto an axis
+ * and finds the extent of the projections, in a single pass.
+ * An empty polygon gives a min of INFINITY and a max of -INFINITY.
+ *
+ * @param points the vertices of the polygon
+ * @param size the number of vertices
+ * @param axis the axis being projected onto
+ * @param min set to the smallest dot product of a vertex with axis
+ * @param max set to the largest dot product of a vertex with axis
+ */
+void polygon_points_project(
+    const vector_t *points,
+    size_t size,
+    vector_t axis,
+    double *min,
+    double *max
+);
+
+/**
+ * Returns whether two bounding boxes overlap.
+ * Boxes that only touch along an edge are not considered overlapping.
+ *
+ * @param box1 the first bounding box
+ * @param box2 the second bounding box
+ * @return true if the interiors of the boxes intersect, false otherwise
+ */
+bool bounding_box_overlap(bounding_box_t box1, bounding_box_t box2);
+
 #endif // #ifndef __POLYGON_H__
@@ -2,6 +2,7 @@
 #define __SCENE_H__
 
 #include "body.h"
+#include "collision.h"
 #include "list.h"
 #include "vector.h"
 #include "image.h"
@@ -59,6 +60,73 @@ void scene_free(scene_t *scene);
  */
 size_t scene_bodies(scene_t *scene);
 
+/**
+ * Gets the most recently added body with a given tag, in constant time.
+ * Bodies marked for removal are still found until the scene frees them.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param tag the tag to look for; see body_set_tag()
+ * @return the body, or NULL if the scene has no body with the tag
+ */
+body_t *scene_get_tagged(scene_t *scene, char tag);
+
+/**
+ * Gets every body in a scene with a given tag, in the order they were added.
+ * The list is owned and kept up to date by the scene,
+ * so it must not be modified or freed.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param tag the tag to look for; see body_set_tag()
+ * @return the list of bodies with the tag
+ */
+list_t *scene_get_tagged_bodies(scene_t *scene, char tag);
+
+/**
+ * A function that decides whether scene_raycast() may hit a body.
+ *
+ * @param body the body the ray passes through
+ * @param aux the auxiliary value passed to scene_raycast()
+ * @return true if the ray may hit the body
+ */
+typedef bool (*raycast_filter_t)(body_t *body, void *aux);
+
+/**
+ * Finds the first body a ray hits, e.g. to aim or to pick a body.
+ * Only bodies in the grid cells the ray crosses are tested.
+ * The grid is rebuilt on the first query after the scene ticks or
+ * gains or loses a body, so bodies moved with body_set_centroid()
+ * since then are found where they were.
+ * Bodies marked for removal and bodies containing origin are never hit.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param origin the start of the ray
+ * @param direction the direction of the ray; need not be a unit vector
+ * @param max_length how far the ray reaches
+ * @param filter if non-NULL, a function that returns false for bodies to ignore
+ * @param aux an auxiliary value to pass to filter
+ * @param hit if non-NULL, where to store where the ray hit the returned body
+ * @return the first body hit, or NULL if the ray hits nothing
+ */
+body_t *scene_raycast(
+    scene_t *scene,
+    vector_t origin,
+    vector_t direction,
+    double max_length,
+    raycast_filter_t filter,
+    void *aux,
+    ray_hit_t *hit
+);
+
+/**
+ * Gets the number of bodies that scene_tick() currently integrates.
+ * Static bodies (infinite mass and no motion) and sleeping bodies are left
+ * out until something wakes them, e.g. a force, impulse or new velocity.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the number of dynamic bodies in the scene
+ */
+size_t scene_dynamic_bodies(scene_t *scene);
+
 /**
  * Gets the body at a given index in a scene.
  * Asserts that the index is valid.
@@ -170,12 +238,93 @@ void scene_add_bodies_force_creator(
     free_func_t freer
 );
 
+/**
+ * Adds a force creator like scene_add_bodies_force_creator(), and promises
+ * that it only reads bodies and calls body_add_force() or body_add_impulse().
+ * Such force creators may run on several threads at once when the scene has
+ * more than one thread (see scene_set_threads()); their forces are collected
+ * per thread and applied before the other force creators run.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param forcer a force creator function that does not change the scene
+ * @param aux an auxiliary value to pass to forcer when it is called;
+ *   it must not be shared with force creators that write to it
+ * @param bodies the list of bodies affected by the force creator
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void scene_add_pure_force_creator(
+    scene_t *scene,
+    force_creator_t forcer,
+    void *aux,
+    list_t *bodies,
+    free_func_t freer
+);
+
+/**
+ * Sets how many threads scene_tick() spreads pure force creators over.
+ * Scenes start with a single thread, which runs every force creator
+ * in the order they were added. With more threads, every pure force
+ * creator runs before the other force creators, so forces on a body
+ * are summed in a different order and results can differ from a
+ * single thread by rounding, unless all the force creators are pure.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param threads the number of threads, including the one calling scene_tick()
+ */
+void scene_set_threads(scene_t *scene, size_t threads);
+
+/**
+ * Adds a force creator to a scene that checks for a collision between
+ * the two bodies in bodies, e.g. calc_collision().
+ * Behaves like scene_add_bodies_force_creator(), except that the scene's
+ * broad phase skips the force creator on ticks where the bounding boxes of
+ * the two bodies do not overlap. The force creator is still invoked on the
+ * first tick after it is added and on the first tick after the bodies stop
+ * overlapping, so it can observe that the bodies have separated.
+ *
+ * Detection can be split from the response by passing a detector, which
+ * is called with the same aux just before forcer on every tick forcer runs.
+ * A detector may only read the bodies and write to aux, so when the scene
+ * has more than one thread (see scene_set_threads()) the detectors of all
+ * collision force creators run in parallel first, and the force creators
+ * then run serially in the order they were added.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param detector if non-NULL, a function that tests the bodies for
+ *   a collision and stores the result in aux
+ * @param forcer a force creator function
+ * @param aux an auxiliary value to pass to detector and forcer when they are called
+ * @param bodies a list containing exactly the two colliding bodies
+ * @param freer if non-NULL, a function to call in order to free aux
+ */
+void scene_add_collision_force_creator(
+    scene_t *scene,
+    force_creator_t detector,
+    force_creator_t forcer,
+    void *aux,
+    list_t *bodies,
+    free_func_t freer
+);
+
 list_t *scene_get_forces(scene_t *scene);
 
+/**
+ * Marks a force creator for removal. It is not called again, and it is
+ * freed along with any other removed forces and bodies at the end of
+ * the next scene_tick().
+ * Use this instead of removing forces from scene_get_forces() directly.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param force a force creator in scene_get_forces(scene)
+ */
+void scene_remove_force(scene_t *scene, force_t *force);
+
 /**
  * Executes a tick of a given scene over a small time interval.
  * This requires executing all the force creators
  * and then ticking each body (see body_tick()).
+ * Collision force creators are first culled by a uniform grid broad phase
+ * over the bodies' bounding boxes (see scene_add_collision_force_creator()).
  * If any bodies are marked for removal, they should be removed from the scene
  * and freed, along with any force creators acting on them.
  *
@@ -3,7 +3,9 @@
 
 #include <stdbool.h>
 #include "color.h"
+#include "frame_timer.h"
 #include "list.h"
+#include "polygon.h"
 #include "scene.h"
 #include "vector.h"
 
@@ -83,6 +85,44 @@ void sdl_clear(void);
  */
 void sdl_draw_polygon(list_t *points, rgb_color_t color);
 
+/**
+ * Draws a polygon from a borrowed view of its vertices and a color.
+ * Unlike sdl_draw_polygon(), the vertices do not need to be in a list,
+ * so a body's shape can be drawn without copying it.
+ *
+ * @param shape the vertices of the polygon
+ * @param color the color used to fill in the polygon
+ */
+void sdl_draw_polygon_view(polygon_view_t shape, rgb_color_t color);
+
+/**
+ * Draws a filled circle with the given center, radius and color.
+ *
+ * @param center the center of the circle, in scene coordinates
+ * @param radius the radius of the circle, in scene units
+ * @param color the color used to fill in the circle
+ */
+void sdl_draw_circle(vector_t center, double radius, rgb_color_t color);
+
+/**
+ * Sets how far between their last two states bodies are drawn by
+ * sdl_draw_body() and the scene renderers, e.g. stepper_get_alpha()
+ * when the scene is ticked with a fixed timestep. Defaults to 1,
+ * which draws bodies exactly where they are.
+ *
+ * @param alpha how far through the last tick, from 0 (its start) to 1 (its end)
+ */
+void sdl_set_interpolation(double alpha);
+
+/**
+ * Draws the shape of a body in its color.
+ * Circles are drawn as circles, and everything else as a polygon.
+ * The body is drawn at the position set by sdl_set_interpolation().
+ *
+ * @param body the body to draw
+ */
+void sdl_draw_body(body_t *body);
+
 /**
  * Displays the rendered frame on the SDL window.
  * Must be called after drawing the polygons in order to show them.
@@ -100,6 +140,15 @@ void sdl_render_scene(scene_t *scene, list_t *textboxes);
 
 void sdl_render_text(scene_t *scene, list_t *textboxes);
 
+/**
+ * Gets the number of draw calls made for the last frame shown by sdl_show().
+ * Shapes and images are batched, so this grows with the number of
+ * distinct textures drawn rather than the number of bodies.
+ *
+ * @return the number of draw calls in the last frame
+ */
+size_t sdl_get_draw_calls(void);
+
 /**
  * Registers a function to be called every time a key is pressed.
  * Overwrites any existing handler.
@@ -130,12 +179,21 @@ void sdl_on_key(key_handler_t handler);
 
 /**
  * Gets the amount of time that has passed since the last time
- * this function was called, in seconds.
+ * this function was called, in seconds, and marks the start of a new frame
+ * on sdl_get_frame_timer(). Measured with a monotonic wall clock.
  *
- * @return the number of seconds that have elapsed
+ * @return the number of seconds that have elapsed, or 0 the first time
  */
 double time_since_last_tick(void);
 
+/**
+ * Gets the frame timer whose frames are marked by time_since_last_tick(),
+ * e.g. to read the frame rate or to time phases of each frame.
+ *
+ * @return the frame timer, which is owned by the SDL wrapper
+ */
+frame_timer_t *sdl_get_frame_timer(void);
+
 /**
 * Frees all of the SDL_Texture types.
 */
@@ -0,0 +1,119 @@
+#ifndef __SPATIAL_HASH_H__
+#define __SPATIAL_HASH_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "list.h"
+#include "polygon.h"
+
+/**
+ * A uniform grid over the plane used as a collision broad phase.
+ * Values (e.g. body_t*) are inserted with their bounding boxes and bucketed
+ * into every grid cell their box covers, so only values sharing a cell
+ * are ever compared against each other.
+ * The hash keeps its storage between clears, so rebuilding it every tick
+ * does not allocate once it has grown to fit the scene.
+ */
+typedef struct spatial_hash spatial_hash_t;
+
+/**
+ * Allocates memory for an empty spatial hash.
+ * Asserts that the cell size is positive and that the memory was allocated.
+ *
+ * @param cell_size the width and height of each grid cell
+ * @return a pointer to the newly allocated spatial hash
+ */
+spatial_hash_t *spatial_hash_init(double cell_size);
+
+/**
+ * Releases the memory allocated for a spatial hash.
+ * Does not free the values that were inserted into it.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ */
+void spatial_hash_free(spatial_hash_t *hash);
+
+/**
+ * Removes every value from a spatial hash, keeping its allocated storage.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ */
+void spatial_hash_clear(spatial_hash_t *hash);
+
+/**
+ * Gets the number of values inserted since the hash was last cleared.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @return the number of values in the hash
+ */
+size_t spatial_hash_size(spatial_hash_t *hash);
+
+/**
+ * Inserts a value into every cell covered by its bounding box.
+ * Boxes covering a very large number of cells are kept aside
+ * and compared against everything instead.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @param value the value to insert; must be non-NULL
+ * @param box the bounding box of the value
+ */
+void spatial_hash_insert(spatial_hash_t *hash, void *value, bounding_box_t box);
+
+/**
+ * Computes every pair of inserted values whose bounding boxes overlap.
+ * Must be called after inserting values and before spatial_hash_has_pair().
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @return the number of distinct overlapping pairs
+ */
+size_t spatial_hash_find_pairs(spatial_hash_t *hash);
+
+/**
+ * Adds every pair of a value in hash and a value in other whose bounding
+ * boxes overlap to the pairs of hash, without pairing the values of other
+ * with each other. Lets a hash of moving values be paired against a hash
+ * of stationary ones that is kept between ticks.
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @param other a pointer to another spatial hash returned from spatial_hash_init()
+ * @return the number of distinct overlapping pairs in hash
+ */
+size_t spatial_hash_find_pairs_with(spatial_hash_t *hash, spatial_hash_t *other);
+
+/**
+ * Returns whether two values were found to overlap by the last call
+ * to spatial_hash_find_pairs() or spatial_hash_find_pairs_with().
+ * The order of the values does not matter.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @param value1 the first value
+ * @param value2 the second value
+ * @return true if the bounding boxes of the values overlap
+ */
+bool spatial_hash_has_pair(spatial_hash_t *hash, void *value1, void *value2);
+
+/**
+ * Appends every inserted value whose bounding box overlaps box to results.
+ * Each value is appended at most once.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @param box the region to search
+ * @param results a list to append the matching values to
+ * @return the number of values appended
+ */
+size_t spatial_hash_query(spatial_hash_t *hash, bounding_box_t box, list_t *results);
+
+/**
+ * Appends every inserted value whose bounding box the segment from start
+ * to end passes through to results, visiting only the cells it crosses.
+ * Each value is appended at most once, roughly in order along the segment.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @param start one end of the segment
+ * @param end the other end of the segment
+ * @param results a list to append the matching values to
+ * @return the number of values appended
+ */
+size_t spatial_hash_query_segment(spatial_hash_t *hash, vector_t start, vector_t end,
+                                  list_t *results);
+
+#endif // #ifndef __SPATIAL_HASH_H__
@@ -0,0 +1,65 @@
+#ifndef __STEPPER_H__
+#define __STEPPER_H__
+
+#include "scene.h"
+#include <stddef.h>
+
+/**
+ * Drives a scene with a fixed timestep, independently of the frame rate.
+ * Each frame's elapsed time is added to an accumulator, and the scene is
+ * ticked in steps of a fixed size while a whole step remains. Every step
+ * is the same size, so the physics no longer depends on how fast frames
+ * are drawn, and a slow frame catches up with several small steps instead
+ * of one large one that could carry a body through a wall.
+ * The time left over is less than a step; see stepper_get_alpha().
+ */
+typedef struct stepper stepper_t;
+
+/**
+ * Allocates memory for a stepper.
+ * Asserts that the required memory is successfully allocated.
+ *
+ * @param step the length of every tick of the scene, in seconds (e.g. 1.0 / 240)
+ * @param max_steps the most ticks to run for one call to stepper_advance();
+ *   time beyond that is dropped so a long stall does not snowball
+ * @return a pointer to the newly allocated stepper
+ */
+stepper_t *stepper_init(double step, size_t max_steps);
+
+/**
+ * Releases the memory allocated for a stepper.
+ *
+ * @param stepper a pointer to a stepper returned from stepper_init()
+ */
+void stepper_free(stepper_t *stepper);
+
+/**
+ * Gets the length of a stepper's ticks.
+ *
+ * @param stepper a pointer to a stepper returned from stepper_init()
+ * @return the length of every tick, in seconds
+ */
+double stepper_get_step(stepper_t *stepper);
+
+/**
+ * Adds elapsed time to a stepper and ticks the scene once for every
+ * whole step accumulated, up to the stepper's maximum.
+ *
+ * @param stepper a pointer to a stepper returned from stepper_init()
+ * @param scene the scene to tick
+ * @param elapsed the time since the last call, in seconds
+ * @return the number of times the scene was ticked
+ */
+size_t stepper_advance(stepper_t *stepper, scene_t *scene, double elapsed);
+
+/**
+ * Gets how far the accumulated time is into the next step, from 0 up to 1.
+ * Drawing bodies this far between their last two states
+ * (see body_get_interpolated_centroid()) hides the steps from the viewer.
+ *
+ * @param stepper a pointer to a stepper returned from stepper_init()
+ * @return the accumulated time as a fraction of a step
+ */
+double stepper_get_alpha(stepper_t *stepper);
+
+#endif // #ifndef __STEPPER_H__
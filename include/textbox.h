@@ -1,12 +1,19 @@
 #ifndef __TEXTBOX_H__
 #define __TEXTBOX_H__
 
+#include <stddef.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
 typedef struct textbox textbox_t;
 
-textbox_t *textbox_init(int x, int y, int width, int height, char *text, TTF_Font *font, SDL_Color color);
+/**
+* Initializes a textbox showing a copy of text in the font at font_path.
+* Each font file is opened once per size and shared by every textbox using it
+* until the last of them is freed.
+*/
+textbox_t *textbox_init(int x, int y, int width, int height, char *text, char *font_path, int font_size,
+                        SDL_Color color);
 
 int textbox_get_x(textbox_t *textbox);
 
@@ -18,10 +25,42 @@ int textbox_get_height(textbox_t *textbox);
 
 char *textbox_get_text(textbox_t *textbox);
 
+/**
+* Sets the text of textbox to a copy of text, rendering it again if it changed
+*/
+void textbox_set_text(textbox_t *textbox, char *text);
+
 TTF_Font *textbox_get_font(textbox_t *textbox);
 
+/**
+* Sets the font of textbox, rendering its text again if the font changed
+*/
+void textbox_set_font(textbox_t *textbox, char *font_path, int font_size);
+
 SDL_Color textbox_get_color(textbox_t *textbox);
 
+/**
+* Sets the color of textbox, rendering its text again if the color changed
+*/
+void textbox_set_color(textbox_t *textbox, SDL_Color color);
+
+/**
+* Returns a texture of the text of textbox for renderer. The text is only
+* rendered when first drawn and after it, its font or its color changes.
+*/
+SDL_Texture *textbox_get_texture(textbox_t *textbox, SDL_Renderer *renderer);
+
+/**
+* Forgets every texture made by textbox_get_texture(), so the next call makes a new one.
+* Must be called when the renderer is destroyed, which destroys its textures.
+*/
+void textbox_invalidate_textures(void);
+
+/**
+* Returns the number of distinct fonts currently open
+*/
+size_t textbox_num_fonts(void);
+
 void textbox_free(textbox_t *textbox);
 
 #endif
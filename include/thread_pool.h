@@ -0,0 +1,60 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <stddef.h>
+
+/**
+ * A fixed set of worker threads that run batches of independent tasks.
+ * The thread calling thread_pool_run() also runs tasks, so a pool
+ * of size n starts n - 1 workers. On platforms without pthreads
+ * a pool has no workers and runs every task on the calling thread.
+ */
+typedef struct thread_pool thread_pool_t;
+
+/**
+ * A task run by a thread pool.
+ *
+ * @param index the index of the task within its batch
+ * @param aux the auxiliary value passed to thread_pool_run()
+ */
+typedef void (*thread_task_t)(size_t index, void *aux);
+
+/**
+ * Starts a thread pool.
+ * Asserts that the memory was allocated and the threads were started.
+ *
+ * @param size the number of threads to run tasks on, including the caller;
+ *   must be at least 1
+ * @return a pointer to the newly allocated thread pool
+ */
+thread_pool_t *thread_pool_init(size_t size);
+
+/**
+ * Stops the threads of a thread pool and releases its memory.
+ *
+ * @param pool a pointer to a thread pool returned from thread_pool_init()
+ */
+void thread_pool_free(thread_pool_t *pool);
+
+/**
+ * Gets the number of threads that run a pool's tasks, including the caller.
+ *
+ * @param pool a pointer to a thread pool returned from thread_pool_init()
+ * @return the number of threads
+ */
+size_t thread_pool_size(thread_pool_t *pool);
+
+/**
+ * Runs task once for every index from 0 to num_tasks - 1, spread over
+ * the pool's threads, and returns once all of them have finished.
+ * Tasks may run in any order and at the same time, so they must not
+ * write to anything another task of the batch reads or writes.
+ *
+ * @param pool a pointer to a thread pool returned from thread_pool_init()
+ * @param num_tasks the number of tasks in the batch
+ * @param task the function to run for each index
+ * @param aux an auxiliary value to pass to every task
+ */
+void thread_pool_run(thread_pool_t *pool, size_t num_tasks, thread_task_t task, void *aux);
+
+#endif // #ifndef __THREAD_POOL_H__
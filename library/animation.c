@@ -0,0 +1,95 @@
+#include "animation.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+const size_t ANIMATION_INITIAL_FRAMES = 4;
+
+typedef struct animation {
+    animation_mode_t mode;
+    image_t **images;
+    // The time at which each frame ends, so frame i is shown in [ends[i - 1], ends[i])
+    double *ends;
+    size_t size;
+    size_t capacity;
+} animation_t;
+
+animation_t *animation_init(animation_mode_t mode) {
+    animation_t *animation = malloc(sizeof(animation_t));
+    assert(animation != NULL && "Could not allocate memory for a new animation.");
+    animation->mode = mode;
+    animation->images = malloc(ANIMATION_INITIAL_FRAMES * sizeof(image_t *));
+    animation->ends = malloc(ANIMATION_INITIAL_FRAMES * sizeof(double));
+    assert(animation->images != NULL && animation->ends != NULL
+           && "Could not allocate memory for animation frames.");
+    animation->size = 0;
+    animation->capacity = ANIMATION_INITIAL_FRAMES;
+    return animation;
+}
+
+animation_t *animation_init_still(image_t *image) {
+    animation_t *animation = animation_init(ANIMATION_ONCE);
+    animation_add_frame(animation, image, 1);
+    return animation;
+}
+
+void animation_free(animation_t *animation) {
+    for (size_t i = 0; i < animation->size; i++) {
+        image_free(animation->images[i]);
+    }
+    free(animation->images);
+    free(animation->ends);
+    free(animation);
+}
+
+void animation_add_frame(animation_t *animation, image_t *image, double duration) {
+    assert(duration > 0);
+    if (animation->size == animation->capacity) {
+        animation->capacity *= 2;
+        animation->images = realloc(animation->images, animation->capacity * sizeof(image_t *));
+        animation->ends = realloc(animation->ends, animation->capacity * sizeof(double));
+        assert(animation->images != NULL && animation->ends != NULL
+               && "Could not grow animation frames.");
+    }
+    double start = animation_get_duration(animation);
+    animation->images[animation->size] = image;
+    animation->ends[animation->size] = start + duration;
+    animation->size++;
+}
+
+size_t animation_num_frames(animation_t *animation) {
+    return animation->size;
+}
+
+double animation_get_duration(animation_t *animation) {
+    return animation->size == 0 ? 0 : animation->ends[animation->size - 1];
+}
+
+bool animation_is_animated(animation_t *animation) {
+    return animation->size > 1;
+}
+
+image_t *animation_get_frame(animation_t *animation, double time) {
+    assert(animation->size > 0 && "Cannot show an animation with no frames.");
+    double duration = animation_get_duration(animation);
+    switch (animation->mode) {
+        case ANIMATION_LOOP:
+            time = fmod(time, duration);
+            break;
+        case ANIMATION_ONCE:
+            break;
+        case ANIMATION_PING_PONG:
+            time = fmod(time, 2 * duration);
+            if (time >= duration) {
+                time = 2 * duration - time;
+            }
+            break;
+    }
+    // Clips have a handful of frames, so a linear search beats anything fancier
+    for (size_t i = 0; i < animation->size; i++) {
+        if (time < animation->ends[i]) {
+            return animation->images[i];
+        }
+    }
+    return animation->images[animation->size - 1];
+}
@@ -1,6 +1,7 @@
 #include "body.h"
 #include "polygon.h"
 #include "image.h"
+#include "animation.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <math.h>
@@ -9,12 +10,63 @@
 #include <stdbool.h>
 
 const size_t INITIAL_COLLIDING_BODIES_LENGTH = 3;
-const double IMG_CHANGE_TIME = 0.03;
+
+// Bodies slower than this for BODY_SLEEP_TICKS consecutive ticks fall asleep
+const double BODY_SLEEP_SPEED = 1e-3;
+const size_t BODY_SLEEP_TICKS = 60;
+
+// Circles also keep a polygon with this many vertices for code that needs one
+const size_t BODY_CIRCLE_VERTICES = 16;
+
+// body_tick_list() integrates this many bodies at a time
+#define BODY_TICK_BLOCK 64
+
+// Shapes with at most this many vertices are stored inside the body itself
+#define BODY_INLINE_VERTICES 16
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+typedef struct {
+    body_t *body;
+    vector_t amount;
+    bool is_impulse;
+} deferred_force_t;
+
+typedef struct body_force_buffer {
+    deferred_force_t *entries;
+    size_t size;
+    size_t capacity;
+} body_force_buffer_t;
+
+// Where this thread's forces and impulses go instead of their bodies, if anywhere
+static THREAD_LOCAL body_force_buffer_t *capturing_buffer = NULL;
 
 typedef struct body {
-    list_t *points;
+    // The shape relative to the centroid at rotation 0
+    vector_t *local_points;
+    // The shape in the plane, recomputed from local_points when dirty
+    vector_t *points;
+    size_t num_points;
+    bool points_dirty;
+    // The bounding box of local_points, and of points when box_dirty is false
+    bounding_box_t local_box;
+    bounding_box_t box;
+    bool box_dirty;
+    // Positive for circles, whose vertices only approximate their shape
+    double radius;
+    // Holds both local_points and points for small shapes
+    vector_t inline_points[2 * BODY_INLINE_VERTICES];
     vector_t velocity;
     vector_t centroid;
+    // The transform before the last tick, for drawing between ticks
+    vector_t previous_centroid;
+    double previous_rotation;
+    // Whether collisions are found along the body's path, not just where it ends up
+    bool bullet;
     rgb_color_t color;
     vector_t force;
     vector_t impulse;
@@ -25,34 +77,104 @@ typedef struct body {
     double rotation;
     double elasticity;
     bool removed;
-    list_t *image_list;
-    bool has_image_list;
-    double image_change_count;
-    size_t image_list_index;
+    // The images to draw, or NULL, and how long they have been playing
+    animation_t *animation;
+    double animation_time;
+    char tag;
+    // The force creators acting on the body, as maintained by its scene
+    list_t *force_creators;
+    body_motion_t motion;
+    size_t rest_ticks;
+    // Whether the last tick applied any force or impulse
+    bool accelerated;
+    list_t *wake_list;
 } body_t;
 
+/**
+ * Copies the vertices of shape into the body's contiguous vertex arrays
+ * and frees shape. Small shapes are stored inline in the body,
+ * so only larger ones need a separate allocation.
+ */
+void body_take_shape(body_t *body, list_t *shape) {
+    size_t n = list_size(shape);
+    body->num_points = n;
+    body->local_points = body->inline_points;
+    if (n > BODY_INLINE_VERTICES) {
+        body->local_points = malloc(sizeof(vector_t) * 2 * n);
+        assert(body->local_points != NULL && "Could not allocate memory for body vertices!");
+    }
+    body->points = body->local_points + n;
+    for (size_t i = 0; i < n; i++) {
+        body->points[i] = *(vector_t *) list_get(shape, i);
+    }
+    body->centroid = polygon_points_centroid(body->points, n);
+    for (size_t i = 0; i < n; i++) {
+        body->local_points[i] = vec_subtract(body->points[i], body->centroid);
+    }
+    body->points_dirty = false;
+    body->local_box = polygon_points_bounding_box(body->local_points, n);
+    body->box = polygon_points_bounding_box(body->points, n);
+    body->box_dirty = false;
+    body->radius = 0.0;
+    body->previous_centroid = body->centroid;
+    list_free(shape);
+}
+
+/**
+ * Recomputes the body's vertices in the plane if it has moved or rotated
+ * since they were last needed.
+ */
+static void body_update_points(body_t *body) {
+    if (body->points_dirty) {
+        polygon_points_transform(body->local_points, body->points, body->num_points,
+                                 body->centroid, body->rotation);
+        body->points_dirty = false;
+    }
+}
+
+/**
+ * Updates the cached bounding box after the body's transform changes.
+ * An unrotated body's box is just its local box moved to the centroid;
+ * a rotated body's box is recomputed from its vertices when next needed.
+ */
+static void body_move_box(body_t *body) {
+    // Rotating a circle does not change its box
+    if (body->rotation == 0.0 || body->radius > 0) {
+        body->box.min = vec_add(body->local_box.min, body->centroid);
+        body->box.max = vec_add(body->local_box.max, body->centroid);
+        body->box_dirty = false;
+    }
+    else {
+        body->box_dirty = true;
+    }
+}
+
 body_t *body_init(list_t *shape, double mass, rgb_color_t color) {
     body_t *body = malloc(sizeof(body_t));
     assert(body != NULL && "Could not allocate memory for new body!");
-    body->info = malloc(sizeof(void *));
 
-    body->points = shape;
+    body_take_shape(body, shape);
     body->velocity = (vector_t) {0, 0};
-    body->centroid = polygon_centroid(shape);
     body->color = color;
     body->force = (vector_t) {0,0};
     body->impulse = (vector_t) {0,0};
     body->mass = mass;
     body->passive_rotation = 0.0;
     body->rotation = 0.0;
+    body->previous_rotation = 0.0;
     body->elasticity = 1.0;
     body->info = NULL;
     body->info_free = NULL;
     body->removed = false;
-    body->image_list = NULL;
-    body->has_image_list = false;
-    body->image_change_count = 0;
-    body->image_list_index = 0;
+    body->animation = NULL;
+    body->animation_time = 0;
+    body->tag = BODY_NO_TAG;
+    body->force_creators = list_init(2, NULL);
+    body->motion = BODY_DYNAMIC;
+    body->rest_ticks = 0;
+    body->accelerated = false;
+    body->wake_list = NULL;
+    body->bullet = false;
     return body;
 }
 
@@ -66,52 +188,108 @@ body_t *body_init_with_info(
     body_t *body = malloc(sizeof(body_t));
     assert(body != NULL && "Could not allocate memory for new body!");
     assert(mass > 0);
-    body->info = malloc(sizeof(void *));
 
-    body->points = shape;
+    body_take_shape(body, shape);
     body->velocity = (vector_t) {0, 0};
-    body->centroid = polygon_centroid(shape);
     body->color = color;
     body->force = (vector_t) {0,0};
     body->impulse = (vector_t) {0,0};
     body->mass = mass;
     body->passive_rotation = 0.0;
     body->rotation = 0.0;
+    body->previous_rotation = 0.0;
     body->elasticity = 1.0;
     body->info = info;
     body->info_free = info_freer;
     body->removed = false;
-    body->image_list = NULL;
-    body->has_image_list = false;
-    body->image_change_count = 0;
-    body->image_list_index = 0;
+    body->animation = NULL;
+    body->animation_time = 0;
+    body->tag = BODY_NO_TAG;
+    body->force_creators = list_init(2, NULL);
+    body->motion = BODY_DYNAMIC;
+    body->rest_ticks = 0;
+    body->accelerated = false;
+    body->wake_list = NULL;
+    body->bullet = false;
     return body;
 }
 
+body_t *body_init_circle(
+    vector_t center,
+    double radius,
+    double mass,
+    rgb_color_t color,
+    void *info,
+    free_func_t info_freer
+){
+    assert(radius > 0);
+    list_t *shape = list_init(BODY_CIRCLE_VERTICES, free);
+    for (size_t i = 0; i < BODY_CIRCLE_VERTICES; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        assert(v != NULL);
+        double angle = 2 * M_PI * i / BODY_CIRCLE_VERTICES;
+        *v = (vector_t) {center.x + radius * cos(angle), center.y + radius * sin(angle)};
+        list_add(shape, v);
+    }
+    body_t *body = body_init_with_info(shape, mass, color, info, info_freer);
+    // The centroid of the regular polygon is only approximately center
+    body->centroid = center;
+    body->previous_centroid = center;
+    for (size_t i = 0; i < body->num_points; i++) {
+        body->local_points[i] = vec_subtract(body->points[i], center);
+    }
+    body->radius = radius;
+    body->local_box = (bounding_box_t) {{-radius, -radius}, {radius, radius}};
+    body_move_box(body);
+    return body;
+}
+
+bool body_is_circle(body_t *body) {
+    return body->radius > 0;
+}
+
+double body_get_radius(body_t *body) {
+    assert(body->radius > 0 && "Only circles have a radius!");
+    return body->radius;
+}
+
 void body_free(body_t *body){
     if (body->info_free != NULL) {
          body->info_free(body->info);
     }
-    list_free(body->points);
-    if (body->has_image_list) {
-        list_free(body->image_list);
+    if (body->local_points != body->inline_points) {
+        free(body->local_points);
+    }
+    if (body->animation != NULL) {
+        animation_free(body->animation);
     }
+    list_free(body->force_creators);
     free(body);
 }
 
-void body_add_image_list(body_t *body, list_t *image_list) {
-    if (list_size(image_list) > 0) {
-        body->image_list = image_list;
-        body->has_image_list = true;
+void body_set_animation(body_t *body, animation_t *animation) {
+    assert(animation_num_frames(animation) > 0);
+    if (body->animation != NULL) {
+        animation_free(body->animation);
     }
+    body->animation = animation;
+    body->animation_time = 0;
+    body_wake(body);
 }
 
-bool body_has_image_list(body_t *body) {
-    return body->has_image_list;
+bool body_has_image(body_t *body) {
+    return body->animation != NULL;
+}
+
+/**
+ * Returns whether a body's image changes as it ticks.
+ */
+static bool body_is_animated(body_t *body) {
+    return body->animation != NULL && animation_is_animated(body->animation);
 }
 
 image_t *body_get_current_image(body_t *body) {
-    return list_get(body->image_list, body->image_list_index);
+    return animation_get_frame(body->animation, body->animation_time);
 }
 
 vector_t *give_vec(void) {
@@ -120,15 +298,66 @@ vector_t *give_vec(void) {
 }
 
 list_t *body_get_shape(body_t *body) {
-    list_t *points_copy = list_init(list_size(body->points), (free_func_t) vec_free);
-    for (int i = 0; i < list_size(body->points); i++) {
+    body_update_points(body);
+    list_t *points_copy = list_init(body->num_points, (free_func_t) vec_free);
+    for (size_t i = 0; i < body->num_points; i++) {
         vector_t *thing = give_vec();
-        memcpy(thing, list_get(body->points, i), sizeof(vector_t));
+        memcpy(thing, &body->points[i], sizeof(vector_t));
         list_add(points_copy, thing);
     }
     return points_copy;
 }
 
+polygon_view_t body_get_shape_view(body_t *body) {
+    body_update_points(body);
+    return (polygon_view_t) {body->points, body->num_points};
+}
+
+size_t body_get_num_vertices(body_t *body) {
+    return body->num_points;
+}
+
+vector_t body_get_interpolated_centroid(body_t *body, double alpha) {
+    vector_t step = vec_subtract(body->centroid, body->previous_centroid);
+    return vec_add(body->previous_centroid, vec_multiply(alpha, step));
+}
+
+polygon_view_t body_get_interpolated_shape(body_t *body, double alpha, vector_t *buffer) {
+    vector_t centroid = body_get_interpolated_centroid(body, alpha);
+    double rotation = body->previous_rotation
+                    + alpha * (body->rotation - body->previous_rotation);
+    if (centroid.x == body->centroid.x && centroid.y == body->centroid.y
+        && rotation == body->rotation) {
+        return body_get_shape_view(body);
+    }
+    polygon_points_transform(body->local_points, buffer, body->num_points, centroid, rotation);
+    return (polygon_view_t) {buffer, body->num_points};
+}
+
+bounding_box_t body_get_bounding_box(body_t *body) {
+    if (body->box_dirty) {
+        body_update_points(body);
+        body->box = polygon_points_bounding_box(body->points, body->num_points);
+        body->box_dirty = false;
+    }
+    return body->box;
+}
+
+vector_t body_get_last_motion(body_t *body) {
+    return vec_subtract(body->centroid, body->previous_centroid);
+}
+
+bounding_box_t body_get_swept_bounding_box(body_t *body) {
+    bounding_box_t box = body_get_bounding_box(body);
+    vector_t motion = body_get_last_motion(body);
+    // The box at the start of the tick is the current box moved back
+    box.min.x += fmin(-motion.x, 0);
+    box.min.y += fmin(-motion.y, 0);
+    box.max.x += fmax(-motion.x, 0);
+    box.max.y += fmax(-motion.y, 0);
+    return box;
+}
+
 vector_t body_get_centroid(body_t *body) {
     return body->centroid;
 }
@@ -157,26 +386,85 @@ void body_set_elasticity(body_t *body, double new_elasticity) {
     body->elasticity = new_elasticity;
 }
 
+/**
+ * Moves a body's centroid without touching its previous centroid.
+ */
+static void body_move_centroid(body_t *body, vector_t x) {
+    if (x.x != body->centroid.x || x.y != body->centroid.y) {
+        body->centroid = x;
+        body->points_dirty = true;
+        body_move_box(body);
+    }
+}
+
+/**
+ * Rotates a body without touching its previous rotation.
+ */
+static void body_move_rotation(body_t *body, double angle) {
+    if (angle != body->rotation) {
+        body->rotation = angle;
+        body->points_dirty = true;
+        body_move_box(body);
+    }
+}
+
 void body_set_centroid(body_t *body, vector_t x) {
-    polygon_translate(body->points, vec_add(x, vec_negate(body->centroid)));
-    body->centroid = x;
+    body_move_centroid(body, x);
+    // Teleports are drawn where they land rather than swept across the screen
+    body->previous_centroid = x;
+    // A moved static body must leave the scene's grid of bodies that are not moving
+    body_wake(body);
 }
 
 void body_redefine_centroid(body_t *body, vector_t new_centroid) {
+    // Shift the local shape so that the vertices stay where they are
+    vector_t shift = vec_rotate(vec_subtract(body->centroid, new_centroid), -body->rotation);
+    polygon_points_translate(body->local_points, body->num_points, shift);
+    body->local_box = polygon_points_bounding_box(body->local_points, body->num_points);
+    // The circle is no longer centered on the centroid, so fall back to its polygon
+    body->radius = 0.0;
     body->centroid = new_centroid;
+    body->previous_centroid = new_centroid;
 }
 
 void body_set_velocity(body_t *body, vector_t v) {
     body->velocity = v;
+    if (v.x != 0 || v.y != 0) {
+        body_wake(body);
+    }
 }
 
 void body_set_passive_rotation(body_t *body, double new_passive_rotation) {
     body->passive_rotation = new_passive_rotation;
+    if (new_passive_rotation != 0) {
+        body_wake(body);
+    }
 }
 
 void body_set_rotation(body_t *body, double angle) {
-    polygon_rotate(body->points, angle - body->rotation, body->centroid);
-    body->rotation = angle;
+    body_move_rotation(body, angle);
+    body->previous_rotation = angle;
+    body_wake(body);
+}
+
+void body_set_bullet(body_t *body, bool bullet) {
+    body->bullet = bullet;
+}
+
+bool body_is_bullet(body_t *body) {
+    return body->bullet;
+}
+
+void body_set_tag(body_t *body, char tag) {
+    body->tag = tag;
+}
+
+char body_get_tag(body_t *body) {
+    return body->tag;
+}
+
+list_t *body_get_force_creators(body_t *body) {
+    return body->force_creators;
 }
 
 void *body_get_info(body_t *body) {
@@ -192,6 +480,27 @@ bool body_is_removed(body_t *body) {
     return body->removed;
 }
 
+/**
+ * Moves a body to its integrated position and velocity, and does
+ * the rest of body_tick(): rotation, resetting forces and animation.
+ */
+static void body_finish_tick(body_t *body, vector_t centroid, vector_t new_vel, double dt) {
+    body->previous_centroid = body->centroid;
+    body->previous_rotation = body->rotation;
+    body_move_centroid(body, centroid);
+    body_move_rotation(body, body->rotation + body->passive_rotation * dt);
+    
+    body->velocity = new_vel;
+    body->accelerated = body->force.x != 0 || body->force.y != 0
+                     || body->impulse.x != 0 || body->impulse.y != 0;
+    body->force = VEC_ZERO;
+    body->impulse = VEC_ZERO;
+    
+    if (body_is_animated(body)) {
+        body->animation_time += dt;
+    }
+}
+
 void body_tick(body_t *body, double dt) {
     vector_t new_vel = vec_add(body->velocity, vec_multiply(dt / body->mass, body->force));
     new_vel = vec_add(new_vel, vec_multiply(1/body->mass, body->impulse));
@@ -200,27 +509,177 @@ void body_tick(body_t *body, double dt) {
 
     double new_x = body->centroid.x + avg_vel.x * dt;
     double new_y = body->centroid.y + avg_vel.y * dt;
-    body_set_centroid(body, (vector_t) {new_x, new_y});
-    body_set_rotation(body, body->rotation + body->passive_rotation * dt);
-    
-    body->velocity = new_vel;
-    body->force = VEC_ZERO;
-    body->impulse = VEC_ZERO;
-    
-    if (body->has_image_list) {
-        body->image_change_count += dt;
+    body_finish_tick(body, (vector_t) {new_x, new_y}, new_vel, dt);
+}
+
+/**
+ * The arithmetic of body_tick() over bodies stored as parallel arrays,
+ * updating x, y, vx and vy in place. Each iteration is independent,
+ * so the compiler can vectorize the loop.
+ */
+static void integrate_block(
+    size_t n,
+    double dt,
+    double *restrict x,
+    double *restrict y,
+    double *restrict vx,
+    double *restrict vy,
+    const double *restrict fx,
+    const double *restrict fy,
+    const double *restrict ix,
+    const double *restrict iy,
+    const double *restrict mass
+) {
+    for (size_t i = 0; i < n; i++) {
+        double dt_mass = dt / mass[i], inverse_mass = 1 / mass[i];
+        double new_vx = vx[i] + dt_mass * fx[i] + inverse_mass * ix[i];
+        double new_vy = vy[i] + dt_mass * fy[i] + inverse_mass * iy[i];
+        x[i] += 0.5 * (new_vx + vx[i]) * dt;
+        y[i] += 0.5 * (new_vy + vy[i]) * dt;
+        vx[i] = new_vx;
+        vy[i] = new_vy;
+    }
+}
 
-        if (body->image_change_count > IMG_CHANGE_TIME) {
-            body->image_list_index = (body->image_list_index + 1) % list_size(body->image_list);
-            body->image_change_count = 0;
+void body_tick_list(list_t *bodies, size_t start, size_t end, double dt) {
+    body_t *block[BODY_TICK_BLOCK];
+    double x[BODY_TICK_BLOCK], y[BODY_TICK_BLOCK], vx[BODY_TICK_BLOCK], vy[BODY_TICK_BLOCK];
+    double fx[BODY_TICK_BLOCK], fy[BODY_TICK_BLOCK], ix[BODY_TICK_BLOCK], iy[BODY_TICK_BLOCK];
+    double mass[BODY_TICK_BLOCK];
+    size_t i = start;
+    while (i < end) {
+        // Gather a block of live bodies into the arrays
+        size_t n = 0;
+        for (; i < end && n < BODY_TICK_BLOCK; i++) {
+            body_t *body = list_get(bodies, i);
+            if (body->removed) {
+                continue;
+            }
+            block[n] = body;
+            x[n] = body->centroid.x;
+            y[n] = body->centroid.y;
+            vx[n] = body->velocity.x;
+            vy[n] = body->velocity.y;
+            fx[n] = body->force.x;
+            fy[n] = body->force.y;
+            ix[n] = body->impulse.x;
+            iy[n] = body->impulse.y;
+            mass[n] = body->mass;
+            n++;
         }
+        integrate_block(n, dt, x, y, vx, vy, fx, fy, ix, iy, mass);
+        for (size_t j = 0; j < n; j++) {
+            body_finish_tick(block[j], (vector_t) {x[j], y[j]}, (vector_t) {vx[j], vy[j]}, dt);
+        }
+    }
+}
+
+/**
+ * Records a force or impulse in this thread's capturing buffer.
+ */
+static void defer_force(body_t *body, vector_t amount, bool is_impulse) {
+    body_force_buffer_t *buffer = capturing_buffer;
+    if (buffer->size == buffer->capacity) {
+        buffer->capacity = buffer->capacity == 0 ? 64 : 2 * buffer->capacity;
+        buffer->entries = realloc(buffer->entries, buffer->capacity * sizeof(deferred_force_t));
+        assert(buffer->entries != NULL && "Could not grow a body force buffer.");
     }
+    buffer->entries[buffer->size++] = (deferred_force_t) {body, amount, is_impulse};
 }
 
 void body_add_force(body_t *body, vector_t force) {
+    if (capturing_buffer != NULL) {
+        defer_force(body, force, false);
+        return;
+    }
     body->force = vec_add(body->force, force);
+    // Forces cannot move a body with infinite mass, so it can stay static
+    if (body->mass != INFINITY && (force.x != 0 || force.y != 0)) {
+        body_wake(body);
+    }
 }
 
 void body_add_impulse(body_t *body, vector_t impulse){
+    if (capturing_buffer != NULL) {
+        defer_force(body, impulse, true);
+        return;
+    }
     body->impulse = vec_add(body->impulse, impulse);
+    if (body->mass != INFINITY && (impulse.x != 0 || impulse.y != 0)) {
+        body_wake(body);
+    }
+}
+
+body_motion_t body_get_motion(body_t *body) {
+    return body->motion;
+}
+
+body_motion_t body_classify(body_t *body) {
+    bool still = body->passive_rotation == 0 && !body_is_animated(body);
+    if (still && body->mass == INFINITY && body->velocity.x == 0 && body->velocity.y == 0) {
+        return BODY_STATIC;
+    }
+    // A body being pushed may be slow only because it is turning around
+    if (still && !body->accelerated && vec_dot(body->velocity, body->velocity) < BODY_SLEEP_SPEED * BODY_SLEEP_SPEED) {
+        body->rest_ticks++;
+    }
+    else {
+        body->rest_ticks = 0;
+    }
+    return body->rest_ticks >= BODY_SLEEP_TICKS ? BODY_SLEEPING : BODY_DYNAMIC;
+}
+
+void body_deactivate(body_t *body, body_motion_t motion, list_t *wake_list) {
+    assert(motion != BODY_DYNAMIC);
+    if (motion == BODY_SLEEPING) {
+        body->velocity = VEC_ZERO;
+    }
+    body->motion = motion;
+    body->wake_list = wake_list;
+    // Bodies that stop ticking are drawn where they stopped
+    body->previous_centroid = body->centroid;
+    body->previous_rotation = body->rotation;
+}
+
+void body_wake(body_t *body) {
+    if (body->motion != BODY_DYNAMIC) {
+        body->motion = BODY_DYNAMIC;
+        body->rest_ticks = 0;
+        if (body->wake_list != NULL) {
+            list_add(body->wake_list, body);
+        }
+        body->wake_list = NULL;
+    }
+}
+
+body_force_buffer_t *body_force_buffer_init(void) {
+    body_force_buffer_t *buffer = malloc(sizeof(body_force_buffer_t));
+    assert(buffer != NULL && "Could not allocate memory for a new body_force_buffer_t.");
+    buffer->entries = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+    return buffer;
+}
+
+void body_force_buffer_free(body_force_buffer_t *buffer) {
+    free(buffer->entries);
+    free(buffer);
+}
+
+void body_force_buffer_capture(body_force_buffer_t *buffer) {
+    capturing_buffer = buffer;
+}
+
+void body_force_buffer_apply(body_force_buffer_t *buffer) {
+    assert(capturing_buffer == NULL && "Cannot apply forces while capturing them.");
+    for (size_t i = 0; i < buffer->size; i++) {
+        deferred_force_t *entry = &buffer->entries[i];
+        if (entry->is_impulse) {
+            body_add_impulse(entry->body, entry->amount);
+        }
+        else {
+            body_add_force(entry->body, entry->amount);
+        }
+    }
+    buffer->size = 0;
 }
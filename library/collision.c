@@ -6,46 +6,13 @@
 #include <stdio.h>
 #include <stdlib.h> 
 #include <math.h>
+#include <assert.h>
 #include "scene.h"
 #include "forces.h"
+#include "polygon.h"
 
-/**
- * Determines the minimum vector projection of the points of
- * a polygon onto an axis.
- *
- * @param shape the shape
- * @param vec the axis being projected onto
- * @return the minimum value of a point projected onto the axis
- */
-double min_proj(list_t *shape, vector_t *vec) {
-    double min_val = 10000000;
-    for(int i = 0; i < list_size(shape); i++) {
-        double val = vec_dot(*(vector_t*) list_get(shape, i), *vec);
-        if(val < min_val) {
-            min_val = val;
-        }
-    }
-    return min_val;
-}
-
-/**
- * Determines the maximum vector projection of the points of
- * a polygon onto an axis.
- *
- * @param shape the shape
- * @param vec the axis being projected onto
- * @return the maximum value of a point projected onto the axis
- */
-double max_proj(list_t *shape, vector_t *vec) {
-    double max_val = -10000000;
-    for(int i = 0; i < list_size(shape); i++) {
-        double val = vec_dot(*(vector_t*) list_get(shape, i), *vec);
-        if(val > max_val) {
-            max_val = val;
-        }
-    }
-    return max_val;
-}
+// Polygons up to this size are copied onto the stack by find_collision()
+#define COLLISION_STACK_VERTICES 128
 
 /**
  * Determines if two ranges are overlapping
@@ -67,48 +34,405 @@ double overlap(double min1, double max1, double min2, double max2) {
 }
 
 
-collision_info_t find_collision(list_t *shape1, list_t *shape2) {
-    size_t size1 = list_size(shape1);
-    size_t size2 = list_size(shape2);
-    list_t *axes = list_init(size1 + size2, (free_func_t) vec_free);
-    for(size_t i = 0; i < size1; i++) {
-        vector_t *vec1 = list_get(shape1, i % size1);
-        vector_t *vec2 = list_get(shape1, (i + 1) % size1);
-        vector_t edge = vec_subtract(*vec2, *vec1);
-        vector_t *vec_perp = malloc(sizeof(vector_t));
-        *vec_perp = (vector_t) {edge.y, -1 * edge.x};
-        list_add(axes, vec_perp);
-    }
-    for(size_t i = 0; i < size2; i++) {
-        vector_t *vec1 = list_get(shape2, i % size2);
-        vector_t *vec2 = list_get(shape2, (i + 1) % size2);
-        vector_t edge = vec_subtract(*vec2, *vec1);
-        vector_t *vec_perp = malloc(sizeof(vector_t));
-        *vec_perp = (vector_t) {edge.y, -1 * edge.x};
-        list_add(axes, vec_perp);
+/**
+ * Checks every edge normal of edges against both shapes.
+ * Stops at the first axis the shapes do not overlap on.
+ *
+ * @param edges the shape whose edge normals are checked
+ * @param edges_size the number of vertices in edges
+ * @param shape1 the first shape passed to find_collision_points()
+ * @param size1 the number of vertices in shape1
+ * @param shape2 the second shape passed to find_collision_points()
+ * @param size2 the number of vertices in shape2
+ * @param min_overlap the smallest overlap found so far, updated in place
+ * @param min_axis the axis of min_overlap, updated in place
+ * @return false if a separating axis was found (stored in min_axis)
+ */
+bool check_edge_axes(
+    const vector_t *edges, size_t edges_size,
+    const vector_t *shape1, size_t size1,
+    const vector_t *shape2, size_t size2,
+    double *min_overlap, vector_t *min_axis
+) {
+    for (size_t i = 0; i < edges_size; i++) {
+        vector_t vec1 = edges[i];
+        vector_t vec2 = edges[(i + 1) % edges_size];
+        vector_t axis = {vec2.y - vec1.y, vec1.x - vec2.x};
+        double min1, max1, min2, max2;
+        polygon_points_project(shape1, size1, axis, &min1, &max1);
+        polygon_points_project(shape2, size2, axis, &min2, &max2);
+        double curr = overlap(min1, max1, min2, max2);
+        if (curr < *min_overlap) {
+            *min_axis = axis;
+            if (curr == 0.0) {
+                return false;
+            }
+            *min_overlap = curr;
+        }
     }
+    return true;
+}
+
+collision_info_t find_collision_points(
+    const vector_t *shape1,
+    size_t size1,
+    const vector_t *shape2,
+    size_t size2
+) {
     double min_overlap = 10000000;
+    vector_t axis = VEC_ZERO;
     collision_info_t ret = {false, VEC_ZERO};
-    for(size_t i = 0; i < list_size(axes); i++) {
-        vector_t *axis = list_get(axes, i);
-        double min1 = min_proj(shape1, axis);
-        double max1 = max_proj(shape1, axis);
-        double min2 = min_proj(shape2, axis);
-        double max2 = max_proj(shape2, axis);
-        double curr = overlap(min1, max1, min2, max2);
-        if(curr < min_overlap) {
-            if (curr == 0.0) {
-                ret.collided = false;
-                ret.axis = vec_multiply(1/sqrt(pow((*axis).x, 2) + pow((*axis).y, 2)), *axis);
+    ret.collided = check_edge_axes(shape1, size1, shape1, size1, shape2, size2, &min_overlap, &axis)
+                && check_edge_axes(shape2, size2, shape1, size1, shape2, size2, &min_overlap, &axis);
+    double length = sqrt(axis.x * axis.x + axis.y * axis.y);
+    if (length != 0.0) {
+        ret.axis = vec_multiply(1 / length, axis);
+    }
+    return ret;
+}
+
+/**
+ * Copies the vertices of a list into a contiguous array.
+ * Uses buffer when the polygon fits in it, and allocates otherwise.
+ *
+ * @param shape the list of vertices
+ * @param buffer scratch space for up to COLLISION_STACK_VERTICES vertices
+ * @return the array of vertices, which must be freed if it is not buffer
+ */
+vector_t *gather_points(list_t *shape, vector_t *buffer) {
+    size_t size = list_size(shape);
+    vector_t *points = buffer;
+    if (size > COLLISION_STACK_VERTICES) {
+        points = malloc(sizeof(vector_t) * size);
+        assert(points != NULL);
+    }
+    for (size_t i = 0; i < size; i++) {
+        points[i] = *(vector_t *) list_get(shape, i);
+    }
+    return points;
+}
+
+collision_info_t find_collision(list_t *shape1, list_t *shape2) {
+    vector_t buffer1[COLLISION_STACK_VERTICES];
+    vector_t buffer2[COLLISION_STACK_VERTICES];
+    vector_t *points1 = gather_points(shape1, buffer1);
+    vector_t *points2 = gather_points(shape2, buffer2);
+    collision_info_t ret = find_collision_points(points1, list_size(shape1), points2, list_size(shape2));
+    if (points1 != buffer1) {
+        free(points1);
+    }
+    if (points2 != buffer2) {
+        free(points2);
+    }
+    return ret;
+}
+
+collision_info_t find_circle_collision(
+    vector_t center1,
+    double radius1,
+    vector_t center2,
+    double radius2
+) {
+    vector_t difference = vec_subtract(center2, center1);
+    double distance_squared = vec_dot(difference, difference);
+    double radii = radius1 + radius2;
+    collision_info_t ret = {distance_squared < radii * radii, (vector_t) {1, 0}};
+    if (distance_squared > 0) {
+        ret.axis = vec_multiply(1 / sqrt(distance_squared), difference);
+    }
+    return ret;
+}
+
+/**
+ * Returns whether a point lies inside a polygon, by counting how many edges
+ * a ray from the point in the +x direction crosses.
+ *
+ * @param point the point to test
+ * @param points the vertices of the polygon
+ * @param size the number of vertices
+ * @return true if the point is inside the polygon
+ */
+bool polygon_contains_point(vector_t point, const vector_t *points, size_t size) {
+    bool inside = false;
+    for (size_t i = 0, j = size - 1; i < size; j = i++) {
+        vector_t a = points[i], b = points[j];
+        if ((a.y > point.y) != (b.y > point.y)
+            && point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+collision_info_t find_circle_polygon_collision(
+    vector_t center,
+    double radius,
+    const vector_t *points,
+    size_t size
+) {
+    // Find the closest point to the center on the polygon's boundary
+    double min_distance_squared = INFINITY;
+    vector_t closest = points[0];
+    vector_t closest_edge = VEC_ZERO;
+    for (size_t i = 0; i < size; i++) {
+        vector_t start = points[i];
+        vector_t edge = vec_subtract(points[(i + 1) % size], start);
+        double length_squared = vec_dot(edge, edge);
+        double t = 0;
+        if (length_squared > 0) {
+            t = fmax(0, fmin(1, vec_dot(vec_subtract(center, start), edge) / length_squared));
+        }
+        vector_t point = vec_add(start, vec_multiply(t, edge));
+        vector_t offset = vec_subtract(point, center);
+        double distance_squared = vec_dot(offset, offset);
+        if (distance_squared < min_distance_squared) {
+            min_distance_squared = distance_squared;
+            closest = point;
+            closest_edge = edge;
+        }
+    }
+
+    collision_info_t ret = {false, VEC_ZERO};
+    bool inside = polygon_contains_point(center, points, size);
+    ret.collided = inside || min_distance_squared < radius * radius;
+    vector_t axis = vec_subtract(closest, center);
+    if (inside) {
+        // The polygon surrounds the center, so it lies away from the nearest edge
+        axis = vec_multiply(-1, axis);
+    }
+    if (min_distance_squared == 0) {
+        axis = (vector_t) {closest_edge.y, -closest_edge.x};
+    }
+    double length = sqrt(vec_dot(axis, axis));
+    if (length != 0.0) {
+        ret.axis = vec_multiply(1 / length, axis);
+    }
+    return ret;
+}
+
+collision_info_t find_body_collision(body_t *body1, body_t *body2) {
+    bool circle1 = body_is_circle(body1), circle2 = body_is_circle(body2);
+    if (circle1 && circle2) {
+        return find_circle_collision(body_get_centroid(body1), body_get_radius(body1),
+                                     body_get_centroid(body2), body_get_radius(body2));
+    }
+    if (circle1) {
+        polygon_view_t shape2 = body_get_shape_view(body2);
+        return find_circle_polygon_collision(body_get_centroid(body1), body_get_radius(body1),
+                                             shape2.points, shape2.size);
+    }
+    if (circle2) {
+        polygon_view_t shape1 = body_get_shape_view(body1);
+        collision_info_t ret = find_circle_polygon_collision(
+            body_get_centroid(body2), body_get_radius(body2), shape1.points, shape1.size);
+        ret.axis = vec_multiply(-1, ret.axis);
+        return ret;
+    }
+    polygon_view_t shape1 = body_get_shape_view(body1);
+    polygon_view_t shape2 = body_get_shape_view(body2);
+    return find_collision_points(shape1.points, shape1.size, shape2.points, shape2.size);
+}
+
+/**
+ * Narrows the times when a moving shape overlaps a stationary one
+ * to those when their projections onto an axis overlap.
+ *
+ * @param edges the shape whose edge normals are checked
+ * @param edges_size the number of vertices in edges
+ * @param shape1 the moving shape passed to find_swept_collision_points()
+ * @param size1 the number of vertices in shape1
+ * @param motion how far shape1 moves
+ * @param shape2 the stationary shape
+ * @param size2 the number of vertices in shape2
+ * @param enter the latest time the shapes start overlapping on an axis, updated in place
+ * @param exit the earliest time the shapes stop overlapping on an axis, updated in place
+ * @param enter_axis the axis of enter, updated in place
+ * @return false if the shapes never overlap on some axis during the motion
+ */
+static bool sweep_edge_axes(
+    const vector_t *edges, size_t edges_size,
+    const vector_t *shape1, size_t size1, vector_t motion,
+    const vector_t *shape2, size_t size2,
+    double *enter, double *exit, vector_t *enter_axis
+) {
+    for (size_t i = 0; i < edges_size; i++) {
+        vector_t vec1 = edges[i];
+        vector_t vec2 = edges[(i + 1) % edges_size];
+        vector_t axis = {vec2.y - vec1.y, vec1.x - vec2.x};
+        double min1, max1, min2, max2;
+        polygon_points_project(shape1, size1, axis, &min1, &max1);
+        polygon_points_project(shape2, size2, axis, &min2, &max2);
+        double speed = vec_dot(motion, axis);
+        if (speed == 0) {
+            if (max1 <= min2 || max2 <= min1) {
+                return false;
+            }
+            continue;
+        }
+        // The times when shape1's projection starts and stops overlapping shape2's
+        double start = (min2 - max1) / speed;
+        double end = (max2 - min1) / speed;
+        if (start > end) {
+            double swap = start;
+            start = end;
+            end = swap;
+        }
+        if (start > *enter) {
+            *enter = start;
+            *enter_axis = axis;
+        }
+        *exit = fmin(*exit, end);
+        // Also give up if they only overlapped before the motion started
+        if (*enter >= *exit || *exit <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+sweep_info_t find_swept_collision_points(
+    const vector_t *shape1,
+    size_t size1,
+    vector_t motion,
+    const vector_t *shape2,
+    size_t size2
+) {
+    sweep_info_t ret = {false, 0, VEC_ZERO};
+    double enter = -INFINITY, exit = 1;
+    vector_t axis = VEC_ZERO;
+    if (!sweep_edge_axes(shape1, size1, shape1, size1, motion, shape2, size2, &enter, &exit, &axis)
+        || !sweep_edge_axes(shape2, size2, shape1, size1, motion, shape2, size2, &enter, &exit, &axis)) {
+        return ret;
+    }
+    if (enter < 0) {
+        // Already overlapping when the motion started
+        collision_info_t overlap = find_collision_points(shape1, size1, shape2, size2);
+        return (sweep_info_t) {true, 0, overlap.axis};
+    }
+    // shape1 was moving towards shape2 along the axis it hit on
+    double length = sqrt(vec_dot(axis, axis));
+    ret.collided = true;
+    ret.time = enter;
+    ret.axis = vec_multiply((vec_dot(axis, motion) < 0 ? -1 : 1) / length, axis);
+    return ret;
+}
+
+sweep_info_t find_body_sweep(body_t *body1, body_t *body2) {
+    sweep_info_t ret = {false, 0, VEC_ZERO};
+    if (!bounding_box_overlap(body_get_swept_bounding_box(body1),
+                              body_get_swept_bounding_box(body2))) {
+        return ret;
+    }
+    // Sweep body1 past body2 as if body2 stood still where it is now
+    vector_t motion = vec_subtract(body_get_last_motion(body1), body_get_last_motion(body2));
+    if (motion.x == 0 && motion.y == 0) {
+        return ret;
+    }
+    polygon_view_t shape1 = body_get_shape_view(body1);
+    polygon_view_t shape2 = body_get_shape_view(body2);
+    vector_t buffer[COLLISION_STACK_VERTICES];
+    vector_t *start = buffer;
+    if (shape1.size > COLLISION_STACK_VERTICES) {
+        start = malloc(sizeof(vector_t) * shape1.size);
+        assert(start != NULL);
+    }
+    for (size_t i = 0; i < shape1.size; i++) {
+        start[i] = vec_subtract(shape1.points[i], motion);
+    }
+    ret = find_swept_collision_points(start, shape1.size, motion, shape2.points, shape2.size);
+    if (start != buffer) {
+        free(start);
+    }
+    return ret;
+}
+
+ray_hit_t find_ray_polygon_hit(
+    vector_t origin,
+    vector_t direction,
+    double max_length,
+    const vector_t *points,
+    size_t size
+) {
+    ray_hit_t ret = {false, 0, VEC_ZERO, VEC_ZERO};
+    // Clockwise polygons have their edge normals flipped to face out
+    double winding = 0;
+    for (size_t i = 0; i < size; i++) {
+        winding += vec_cross(points[i], points[(i + 1) % size]);
+    }
+    double facing = winding < 0 ? -1 : 1;
+
+    // Clip the ray against the inside of every edge (Cyrus-Beck)
+    double enter = -INFINITY, exit = max_length;
+    vector_t normal = VEC_ZERO;
+    for (size_t i = 0; i < size; i++) {
+        vector_t vec1 = points[i];
+        vector_t vec2 = points[(i + 1) % size];
+        vector_t outward = {facing * (vec2.y - vec1.y), facing * (vec1.x - vec2.x)};
+        // How far outside the edge the origin is, and how fast the ray leaves it
+        double outside = vec_dot(outward, vec_subtract(origin, vec1));
+        double speed = vec_dot(outward, direction);
+        if (speed == 0) {
+            if (outside >= 0) {
                 return ret;
             }
-            else {
-                min_overlap = curr;
-                ret.axis = vec_multiply(1/sqrt(pow((*axis).x, 2) + pow((*axis).y, 2)), *axis);
+            continue;
+        }
+        double time = -outside / speed;
+        if (speed < 0) {
+            if (time > enter) {
+                enter = time;
+                normal = outward;
             }
         }
+        else {
+            exit = fmin(exit, time);
+        }
+        if (enter >= exit) {
+            return ret;
+        }
     }
-    ret.collided = true;
-    list_free(axes);
+    if (enter < 0) {
+        return ret;
+    }
+    ret.hit = true;
+    ret.distance = enter;
+    ret.point = vec_add(origin, vec_multiply(enter, direction));
+    ret.normal = vec_multiply(1 / sqrt(vec_dot(normal, normal)), normal);
     return ret;
 }
+
+ray_hit_t find_ray_circle_hit(
+    vector_t origin,
+    vector_t direction,
+    double max_length,
+    vector_t center,
+    double radius
+) {
+    ray_hit_t ret = {false, 0, VEC_ZERO, VEC_ZERO};
+    // Solve |origin + t direction - center| = radius for the smaller t
+    vector_t offset = vec_subtract(origin, center);
+    double along = vec_dot(offset, direction);
+    double outside = vec_dot(offset, offset) - radius * radius;
+    double discriminant = along * along - outside;
+    if (outside <= 0 || along >= 0 || discriminant <= 0) {
+        return ret;
+    }
+    double distance = -along - sqrt(discriminant);
+    if (distance > max_length) {
+        return ret;
+    }
+    ret.hit = true;
+    ret.distance = distance;
+    ret.point = vec_add(origin, vec_multiply(distance, direction));
+    ret.normal = vec_multiply(1 / radius, vec_subtract(ret.point, center));
+    return ret;
+}
+
+ray_hit_t find_ray_body_hit(vector_t origin, vector_t direction, double max_length, body_t *body) {
+    if (body_is_circle(body)) {
+        return find_ray_circle_hit(origin, direction, max_length,
+                                   body_get_centroid(body), body_get_radius(body));
+    }
+    polygon_view_t shape = body_get_shape_view(body);
+    return find_ray_polygon_hit(origin, direction, max_length, shape.points, shape.size);
+}
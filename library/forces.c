@@ -5,6 +5,7 @@
 #include "forces.h"
 #include "my_aux.h"
 #include "collision.h"
+#include "nbody.h"
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -46,6 +47,85 @@ void calc_grav_force(aux_t *aux){
 
 }
 
+typedef struct nbody_gravity {
+    scene_t *scene;
+    double G;
+    char tag;
+    double theta;
+    // Gathered bodies and their positions, masses and forces, reused every tick
+    body_t **bodies;
+    double *x;
+    double *y;
+    double *mass;
+    double *fx;
+    double *fy;
+    size_t capacity;
+} nbody_gravity_t;
+
+void nbody_gravity_free(nbody_gravity_t *gravity) {
+    free(gravity->bodies);
+    free(gravity->x);
+    free(gravity->y);
+    free(gravity->mass);
+    free(gravity->fx);
+    free(gravity->fy);
+    free(gravity);
+}
+
+static void nbody_gravity_reserve(nbody_gravity_t *gravity, size_t needed) {
+    if (needed <= gravity->capacity) {
+        return;
+    }
+    size_t capacity = gravity->capacity == 0 ? 16 : gravity->capacity;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    gravity->bodies = realloc(gravity->bodies, capacity * sizeof(body_t *));
+    gravity->x = realloc(gravity->x, capacity * sizeof(double));
+    gravity->y = realloc(gravity->y, capacity * sizeof(double));
+    gravity->mass = realloc(gravity->mass, capacity * sizeof(double));
+    gravity->fx = realloc(gravity->fx, capacity * sizeof(double));
+    gravity->fy = realloc(gravity->fy, capacity * sizeof(double));
+    assert(gravity->bodies != NULL && gravity->x != NULL && gravity->y != NULL
+           && gravity->mass != NULL && gravity->fx != NULL && gravity->fy != NULL
+           && "Could not grow the n-body gravity buffers.");
+    gravity->capacity = capacity;
+}
+
+void calc_nbody_gravity(nbody_gravity_t *gravity) {
+    list_t *tagged = scene_get_tagged_bodies(gravity->scene, gravity->tag);
+    nbody_gravity_reserve(gravity, list_size(tagged));
+
+    // Gather the live bodies into flat arrays for the kernel
+    size_t n = 0;
+    for (size_t i = 0; i < list_size(tagged); i++) {
+        body_t *body = list_get(tagged, i);
+        if (body_is_removed(body)) {
+            continue;
+        }
+        vector_t centroid = body_get_centroid(body);
+        gravity->bodies[n] = body;
+        gravity->x[n] = centroid.x;
+        gravity->y[n] = centroid.y;
+        gravity->mass[n] = body_get_mass(body);
+        gravity->fx[n] = 0;
+        gravity->fy[n] = 0;
+        n++;
+    }
+
+    if (gravity->theta > 0) {
+        nbody_barnes_hut_forces(n, gravity->x, gravity->y, gravity->mass, gravity->G,
+                                MIN_GRAV_DISTANCE, gravity->theta, gravity->fx, gravity->fy);
+    }
+    else {
+        nbody_pairwise_forces(n, gravity->x, gravity->y, gravity->mass, gravity->G,
+                              MIN_GRAV_DISTANCE, gravity->fx, gravity->fy);
+    }
+    for (size_t i = 0; i < n; i++) {
+        body_add_force(gravity->bodies[i], (vector_t) {gravity->fx[i], gravity->fy[i]});
+    }
+}
+
 void calc_spring_force(aux_t *aux) {
     body_t *body1 = aux_get_body1(aux);
     body_t *body2 = aux_get_body2(aux);
@@ -69,16 +149,81 @@ void destructive_collision(body_t *body1, body_t *body2, vector_t axis, void *au
     body_remove(body2);
 }
 
+/**
+ * Cheaply checks whether two bodies might be colliding
+ * by comparing their cached bounding boxes.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @return false if the bodies definitely do not overlap
+ */
+bool bodies_may_overlap(body_t *body1, body_t *body2) {
+    return bounding_box_overlap(body_get_bounding_box(body1), body_get_bounding_box(body2));
+}
+
+/**
+ * Checks whether two bodies overlap, trying the bounding boxes before SAT.
+ *
+ * @param body1 the first body
+ * @param body2 the second body
+ * @return true if the bodies are colliding
+ */
+bool bodies_collide(body_t *body1, body_t *body2) {
+    return bodies_may_overlap(body1, body2) && find_body_collision(body1, body2).collided;
+}
+
+void detect_collision(aux_t *aux) {
+    body_t *body1 = aux_get_body1(aux);
+    body_t *body2 = aux_get_body2(aux);
+    // Bodies whose bounding boxes are apart cannot collide, so skip the SAT test
+    collision_info_t info = {false, VEC_ZERO};
+    if (bodies_may_overlap(body1, body2)) {
+        info = find_body_collision(body1, body2);
+    }
+    // A bullet may have passed all the way through body2 during the last tick
+    sweep_info_t sweep = {false, 1, VEC_ZERO};
+    if (!info.collided && (body_is_bullet(body1) || body_is_bullet(body2))) {
+        sweep = find_body_sweep(body1, body2);
+        info = (collision_info_t) {sweep.collided, sweep.axis};
+    }
+    aux_set_contact(aux, info);
+    if (sweep.collided) {
+        aux_set_contact_time(aux, sweep.time);
+    }
+}
+
+/**
+ * Moves a bullet back along the last tick to where it first touched
+ * the other body, so collision handlers see the bodies where they hit.
+ * Only body1 moves unless body2 is the only bullet.
+ */
+static void rewind_to_contact(body_t *body1, body_t *body2, double time) {
+    vector_t motion = vec_subtract(body_get_last_motion(body1), body_get_last_motion(body2));
+    vector_t rewind = vec_multiply(1 - time, motion);
+    if (body_is_bullet(body1)) {
+        body_set_centroid(body1, vec_subtract(body_get_centroid(body1), rewind));
+    }
+    else {
+        body_set_centroid(body2, vec_add(body_get_centroid(body2), rewind));
+    }
+}
+
 void calc_collision(aux_t *aux){
     body_t *body1 = aux_get_body1(aux);
     body_t *body2 = aux_get_body2(aux);
     collision_handler_t collision = (collision_handler_t) aux_get_collision(aux);
     void *aux_info = aux_get_aux_info(aux);
 
-    if(find_collision(body_get_shape(body1), body_get_shape(body2)).collided){
+    // The scene runs detect_collision() first, possibly on another thread
+    collision_info_t info = aux_get_contact(aux);
+    if(info.collided){
         if (! aux_get_collided_last_frame(aux)) {
-        collision(body1, body2, find_collision(body_get_shape(body1), body_get_shape(body2)).axis, aux_info);
-        aux_set_collided_last_frame(aux, true);
+            double time = aux_get_contact_time(aux);
+            if (time < 1) {
+                rewind_to_contact(body1, body2, time);
+            }
+            collision(body1, body2, info.axis, aux_info);
+            aux_set_collided_last_frame(aux, true);
         }
     }
     else if (aux_get_collided_last_frame(aux)) {
@@ -91,7 +236,14 @@ void calc_interaction(aux_t *aux){
     body_t *body2 = aux_get_body2(aux);
     collision_handler_t collision = (collision_handler_t) aux_get_collision(aux);
     void *aux_info = aux_get_aux_info(aux);
-    collision(body1, body2, find_collision(body_get_shape(body1), body_get_shape(body2)).axis, aux_info);
+    vector_t axis;
+    if (bodies_may_overlap(body1, body2)) {
+        axis = find_body_collision(body1, body2).axis;
+    }
+    else {
+        axis = unit_vec(body1, body2);
+    }
+    collision(body1, body2, axis, aux_info);
 }
 
 void create_collision(
@@ -108,7 +260,8 @@ void create_collision(
     list_t *bodies = list_init(2, (free_func_t) body_free);
     list_add(bodies, body1);
     list_add(bodies, body2);
-    scene_add_bodies_force_creator(scene, (force_creator_t) calc_collision, aux_info, bodies, (free_func_t) freer);
+    scene_add_collision_force_creator(scene, (force_creator_t) detect_collision,
+        (force_creator_t) calc_collision, aux_info, bodies, (free_func_t) freer);
 }
 
 
@@ -134,7 +287,8 @@ void impulse_collision(body_t *body1, body_t *body2, vector_t axis, void *aux) {
     double m2 = body_get_mass(body2);
     assert(!(m1 == INFINITY && m2 == INFINITY) && "Tried to apply impulse to two infinite masses!");
 
-    vector_t collision_axis = find_collision(body_get_shape(body1), body_get_shape(body2)).axis;
+    // calc_collision() passes the axis it just computed from the same shapes
+    vector_t collision_axis = axis;
     double u1 = vec_dot(collision_axis, body_get_velocity(body1));
     double u2 = vec_dot(collision_axis, body_get_velocity(body2));
 
@@ -164,7 +318,17 @@ void create_newtonian_gravity(scene_t *scene, double G, body_t *body1, body_t *b
     list_t *bodies = list_init(2, (free_func_t) body_free);
     list_add(bodies, body1);
     list_add(bodies, body2);
-    scene_add_bodies_force_creator(scene, (force_creator_t) calc_grav_force, aux_info, bodies, (free_func_t) aux_free);
+    scene_add_pure_force_creator(scene, (force_creator_t) calc_grav_force, aux_info, bodies, (free_func_t) aux_free);
+}
+
+void create_nbody_gravity(scene_t *scene, double G, char tag, double theta) {
+    assert(tag != BODY_NO_TAG);
+    nbody_gravity_t *gravity = malloc(sizeof(nbody_gravity_t));
+    assert(gravity != NULL && "Could not allocate memory for n-body gravity.");
+    *gravity = (nbody_gravity_t) {scene, G, tag, theta, NULL, NULL, NULL, NULL, NULL, NULL, 0};
+    // The force acts on a changing set of bodies, so it is not tied to any of them
+    scene_add_force_creator(scene, (force_creator_t) calc_nbody_gravity, gravity,
+                            (free_func_t) nbody_gravity_free);
 }
 
 void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2) {
@@ -172,14 +336,14 @@ void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2) {
     list_t *bodies = list_init(2, (free_func_t) body_free);
     list_add(bodies, body1);
     list_add(bodies, body2);
-    scene_add_bodies_force_creator(scene, (force_creator_t) calc_spring_force, aux_info, bodies, (free_func_t) aux_free);
+    scene_add_pure_force_creator(scene, (force_creator_t) calc_spring_force, aux_info, bodies, (free_func_t) aux_free);
 }
 
 void create_drag(scene_t *scene, double gamma, body_t *body) {
     aux_t *aux_info = aux_init(gamma, body, NULL);
     list_t *bodies = list_init(1, (free_func_t) body_free);
     list_add(bodies, body);
-    scene_add_bodies_force_creator(scene, (force_creator_t) calc_drag_force, aux_info, bodies, (free_func_t) aux_free);
+    scene_add_pure_force_creator(scene, (force_creator_t) calc_drag_force, aux_info, bodies, (free_func_t) aux_free);
 }
 
 void create_destructive_collision(scene_t *scene, body_t *body1, body_t *body2) {
@@ -189,7 +353,8 @@ void create_destructive_collision(scene_t *scene, body_t *body1, body_t *body2)
     list_t *bodies = list_init(2, (free_func_t) body_free);
     list_add(bodies, body1);
     list_add(bodies, body2);
-    scene_add_bodies_force_creator(scene, (force_creator_t) calc_collision, aux_info, bodies, (free_func_t) aux_free);
+    scene_add_collision_force_creator(scene, (force_creator_t) detect_collision,
+        (force_creator_t) calc_collision, aux_info, bodies, (free_func_t) aux_free);
 }
 
 void create_half_destruction(scene_t *scene, body_t *body1, body_t *body2) {
@@ -199,7 +364,8 @@ void create_half_destruction(scene_t *scene, body_t *body1, body_t *body2) {
     list_t *bodies = list_init(2, (free_func_t) body_free);
     list_add(bodies, body1);
     list_add(bodies, body2);
-    scene_add_bodies_force_creator(scene, (force_creator_t) calc_collision, aux_info, bodies, (free_func_t) aux_free);
+    scene_add_collision_force_creator(scene, (force_creator_t) detect_collision,
+        (force_creator_t) calc_collision, aux_info, bodies, (free_func_t) aux_free);
 }
 
 void create_physics_collision(scene_t *scene, double elasticity, body_t *body1, body_t *body2) {
@@ -211,7 +377,8 @@ void create_physics_collision(scene_t *scene, double elasticity, body_t *body1,
     list_t *bodies = list_init(2, (free_func_t) body_free);
     list_add(bodies, body1);
     list_add(bodies, body2);
-    scene_add_bodies_force_creator(scene, (force_creator_t) calc_collision, aux_info, bodies, (free_func_t) aux_free);
+    scene_add_collision_force_creator(scene, (force_creator_t) detect_collision,
+        (force_creator_t) calc_collision, aux_info, bodies, (free_func_t) aux_free);
 }
 
 
@@ -222,10 +389,10 @@ void calc_tongue_force(aux_t *aux){
     list_t *collidables = aux_get_aux_info(aux);
 
     for(size_t i = 0; i < list_size(collidables); i++){
-        if(find_collision(body_get_shape(body1), body_get_shape(list_get(collidables, i))).collided){
+        if(bodies_collide(body1, list_get(collidables, i))){
             return;
         }
-        if(body_get_mass(body2) != INFINITY && find_collision(body_get_shape(body2), body_get_shape(list_get(collidables, i))).collided){
+        if(body_get_mass(body2) != INFINITY && bodies_collide(body2, list_get(collidables, i))){
             return;
         }
     }
@@ -247,7 +414,7 @@ void calc_univ_grav_force(aux_t *aux) {
     vector_t force = {0, -1 * aux_get_constant(aux)};
     bool found = false;
     for(size_t i = 0; i < list_size(interactables); i++){
-        if(find_collision(body_get_shape(body1), body_get_shape(list_get(interactables, i))).collided){
+        if(bodies_collide(body1, list_get(interactables, i))){
             found = true;
             //vector_t current_cen = body_get_centroid(body1);
             //body_set_centroid(body1, (vector_t) {current_cen.x, current_cen.y + 10});
@@ -0,0 +1,141 @@
+#include "frame_timer.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+const size_t INITIAL_FRAME_TIMER_PHASES = 4;
+// Each new frame contributes this fraction of the smoothed values
+const double FRAME_TIMER_SMOOTHING = 0.1;
+
+typedef struct {
+    const char *name;
+    // When the phase was started, if it is running
+    double start;
+    bool running;
+    // The total time of the phase in the current frame
+    double frame_time;
+    double smoothed_time;
+} phase_t;
+
+typedef struct frame_timer {
+    // The time of the last frame_timer_tick(), or negative before the first
+    double last_tick;
+    double dt;
+    // The smoothed length of a frame, or 0 before one has been timed
+    double smoothed_dt;
+    phase_t *phases;
+    size_t num_phases;
+    size_t phases_capacity;
+} frame_timer_t;
+
+double frame_timer_now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart / frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+frame_timer_t *frame_timer_init(void) {
+    frame_timer_t *timer = malloc(sizeof(frame_timer_t));
+    assert(timer != NULL && "Could not allocate memory for a new frame_timer_t.");
+    timer->last_tick = -1;
+    timer->dt = 0;
+    timer->smoothed_dt = 0;
+    timer->phases = malloc(sizeof(phase_t) * INITIAL_FRAME_TIMER_PHASES);
+    assert(timer->phases != NULL && "Could not allocate memory for frame timer phases.");
+    timer->num_phases = 0;
+    timer->phases_capacity = INITIAL_FRAME_TIMER_PHASES;
+    return timer;
+}
+
+void frame_timer_free(frame_timer_t *timer) {
+    free(timer->phases);
+    free(timer);
+}
+
+/**
+ * Moves a value the smoothing fraction of the way toward a new sample,
+ * or straight to it if there is no history yet.
+ */
+static double smooth(double average, double sample, bool first) {
+    return first ? sample : average + FRAME_TIMER_SMOOTHING * (sample - average);
+}
+
+double frame_timer_tick(frame_timer_t *timer) {
+    double now = frame_timer_now();
+    if (timer->last_tick < 0) {
+        // Nothing has been timed yet, so there is no frame to report
+        timer->last_tick = now;
+        timer->dt = 0;
+        return 0;
+    }
+    bool first = timer->smoothed_dt == 0;
+    timer->dt = now - timer->last_tick;
+    timer->last_tick = now;
+    timer->smoothed_dt = smooth(timer->smoothed_dt, timer->dt, first);
+    for (size_t i = 0; i < timer->num_phases; i++) {
+        phase_t *phase = &timer->phases[i];
+        phase->smoothed_time = smooth(phase->smoothed_time, phase->frame_time, first);
+        phase->frame_time = 0;
+    }
+    return timer->dt;
+}
+
+double frame_timer_get_dt(frame_timer_t *timer) {
+    return timer->dt;
+}
+
+double frame_timer_get_fps(frame_timer_t *timer) {
+    return timer->smoothed_dt > 0 ? 1 / timer->smoothed_dt : 0;
+}
+
+size_t frame_timer_add_phase(frame_timer_t *timer, const char *name) {
+    if (timer->num_phases == timer->phases_capacity) {
+        timer->phases_capacity *= 2;
+        timer->phases = realloc(timer->phases, sizeof(phase_t) * timer->phases_capacity);
+        assert(timer->phases != NULL && "Could not grow frame timer phases.");
+    }
+    timer->phases[timer->num_phases] = (phase_t) {name, 0, false, 0, 0};
+    return timer->num_phases++;
+}
+
+size_t frame_timer_num_phases(frame_timer_t *timer) {
+    return timer->num_phases;
+}
+
+const char *frame_timer_get_phase_name(frame_timer_t *timer, size_t phase) {
+    assert(phase < timer->num_phases);
+    return timer->phases[phase].name;
+}
+
+void frame_timer_start_phase(frame_timer_t *timer, size_t phase) {
+    assert(phase < timer->num_phases);
+    assert(!timer->phases[phase].running && "Phase was started twice.");
+    timer->phases[phase].running = true;
+    timer->phases[phase].start = frame_timer_now();
+}
+
+void frame_timer_stop_phase(frame_timer_t *timer, size_t phase) {
+    assert(phase < timer->num_phases);
+    phase_t *p = &timer->phases[phase];
+    assert(p->running && "Phase was stopped without being started.");
+    p->frame_time += frame_timer_now() - p->start;
+    p->running = false;
+}
+
+double frame_timer_get_phase_time(frame_timer_t *timer, size_t phase) {
+    assert(phase < timer->num_phases);
+    return timer->phases[phase].smoothed_time;
+}
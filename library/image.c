@@ -1,21 +1,97 @@
 #include "image.h"
 #include "vector.h"
+#include "list.h"
 #include <assert.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 
-typedef struct image {
+// Bumped by image_invalidate_textures(), so textures from older renderers are not reused
+static size_t texture_generation = 0;
+
+/**
+ * A decoded image file, shared by every image_t made from the same path.
+ */
+typedef struct image_asset {
+    char *path;
     SDL_Surface *surface;
+    // The surface uploaded to the renderer, or NULL until it is first drawn
+    SDL_Texture *texture;
+    size_t texture_generation;
+    // The number of images using the asset; it is freed when this reaches 0
+    size_t references;
+} image_asset_t;
+
+// Every asset with at least one reference, searched by path
+static list_t *assets = NULL;
+
+typedef struct image {
+    image_asset_t *asset;
     vector_t dimensions;
     double rotation;
     bool show;
 } image_t;
 
+/**
+ * Returns the asset loaded from path, decoding the file if no image uses it yet.
+ */
+static image_asset_t *image_asset_acquire(char *path) {
+    if (assets == NULL) {
+        assets = list_init(8, NULL);
+    }
+    for (size_t i = 0; i < list_size(assets); i++) {
+        image_asset_t *asset = list_get(assets, i);
+        if (strcmp(asset->path, path) == 0) {
+            asset->references++;
+            return asset;
+        }
+    }
+    image_asset_t *asset = malloc(sizeof(image_asset_t));
+    assert(asset != NULL && "Could not allocate memory for a new image asset");
+    asset->surface = IMG_Load(path);
+    assert(asset->surface != NULL && "Could not generate SDL_Surface from image name");
+    asset->path = malloc(strlen(path) + 1);
+    strcpy(asset->path, path);
+    asset->texture = NULL;
+    asset->texture_generation = texture_generation;
+    asset->references = 1;
+    list_add(assets, asset);
+    return asset;
+}
+
+/**
+ * Returns whether the asset's texture belongs to the current renderer.
+ */
+static bool image_asset_has_texture(image_asset_t *asset) {
+    return asset->texture != NULL && asset->texture_generation == texture_generation;
+}
+
+/**
+ * Drops one reference to asset, freeing it once no image uses it.
+ */
+static void image_asset_release(image_asset_t *asset) {
+    if (--asset->references > 0) {
+        return;
+    }
+    list_remove(assets, list_index_of(assets, asset));
+    if (image_asset_has_texture(asset)) {
+        SDL_DestroyTexture(asset->texture);
+    }
+    SDL_FreeSurface(asset->surface);
+    free(asset->path);
+    free(asset);
+    if (list_size(assets) == 0) {
+        list_free(assets);
+        assets = NULL;
+    }
+}
+
 image_t *image_init(char *name, vector_t dimensions, double rotation) {
     image_t *image = malloc(sizeof(image_t));
-    image->surface = IMG_Load(name);
-    assert(image->surface != NULL && "Could not generate SDL_Surface from image name");
+    assert(image != NULL && "Could not allocate memory for a new image_t");
+    image->asset = image_asset_acquire(name);
     image->dimensions = dimensions;
     image->rotation = rotation;
     image->show = true;
@@ -23,7 +99,26 @@ image_t *image_init(char *name, vector_t dimensions, double rotation) {
 }
 
 SDL_Surface *image_get_surface(image_t *image) {
-    return image->surface;
+    return image->asset->surface;
+}
+
+SDL_Texture *image_get_texture(image_t *image, SDL_Renderer *renderer) {
+    image_asset_t *asset = image->asset;
+    if (!image_asset_has_texture(asset)) {
+        // Any older texture was destroyed along with its renderer
+        asset->texture = SDL_CreateTextureFromSurface(renderer, asset->surface);
+        assert(asset->texture != NULL && "Could not create SDL_Texture from image surface");
+        asset->texture_generation = texture_generation;
+    }
+    return asset->texture;
+}
+
+void image_invalidate_textures(void) {
+    texture_generation++;
+}
+
+size_t image_num_assets(void) {
+    return assets == NULL ? 0 : list_size(assets);
 }
 
 vector_t image_get_dimensions(image_t *image) {
@@ -43,6 +138,6 @@ bool image_get_show(image_t *image) {
 }
 
 void image_free(image_t *image) {
-    SDL_FreeSurface(image->surface);
+    image_asset_release(image->asset);
     free(image);
 }
@@ -19,7 +19,6 @@ typedef struct list {
 list_t *list_init(size_t initial_size, free_func_t freer) {
     list_t *list = malloc(sizeof(list_t));
     assert(list != NULL && "Could not allocate memory for a new list_t.");
-    assert(list->items != NULL && "Could not allocate memory for array of generic types.");
     list->free_func = freer;
     list->size = 0;
     if (initial_size == 0) {
@@ -29,6 +28,7 @@ list_t *list_init(size_t initial_size, free_func_t freer) {
         list->capacity = initial_size;
     }
     list->items = malloc(list->capacity * sizeof(void *));
+    assert(list->items != NULL && "Could not allocate memory for array of generic types.");
 
     return list;
 }
@@ -39,9 +39,7 @@ void list_free(list_t *list) {
             list->free_func(list->items[i]);
         }
     }
-    if(list->size != 0){
-        free(list->items);
-    }
+    free(list->items);
     free(list);
 }
 
@@ -54,6 +52,12 @@ void *list_get(list_t *list, size_t index) {
     return list->items[index];
 }
 
+void list_set(list_t *list, size_t index, void *value) {
+    assert(index < list->size);
+    assert(value != NULL);
+    list->items[index] = value;
+}
+
 void list_add(list_t *list, void *value){
     list_add_back(list, value);
 }
@@ -91,6 +95,24 @@ void list_add_back(list_t *list, void *item) {
     list->size++;
 }
 
+size_t list_remove_if(list_t *list, list_predicate_t should_remove, void *aux) {
+    size_t kept = 0;
+    for (size_t i = 0; i < list->size; i++) {
+        void *item = list->items[i];
+        if (should_remove(item, aux)) {
+            if (list->free_func != NULL) {
+                list->free_func(item);
+            }
+        }
+        else {
+            list->items[kept++] = item;
+        }
+    }
+    size_t removed = list->size - kept;
+    list->size = kept;
+    return removed;
+}
+
 void *list_remove_back(list_t *list){
     return list_remove(list, list->size - 1);
 }
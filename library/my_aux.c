@@ -11,6 +11,8 @@ typedef struct aux {
     body_t *body2;
     void *aux_info;
     void *collision;
+    collision_info_t contact;
+    double contact_time;
 } aux_t;
 
 aux_t *aux_init(double constant, body_t *body1, body_t *body2) {
@@ -26,6 +28,8 @@ aux_t *aux_init(double constant, body_t *body1, body_t *body2) {
     new_aux->aux_info = NULL;
     new_aux->collision = NULL;
     new_aux->collided_last_frame = false;
+    new_aux->contact = (collision_info_t) {false, VEC_ZERO};
+    new_aux->contact_time = 1;
 
     return new_aux;
 }
@@ -71,3 +75,21 @@ void aux_set_aux_info(aux_t *aux, void *info){
 void aux_set_collided_last_frame(aux_t *aux, bool new_val) {
     aux->collided_last_frame = new_val;
 }
+
+collision_info_t aux_get_contact(aux_t *aux) {
+    return aux->contact;
+}
+
+void aux_set_contact(aux_t *aux, collision_info_t contact) {
+    aux->contact = contact;
+    aux->contact_time = 1;
+}
+
+double aux_get_contact_time(aux_t *aux) {
+    return aux->contact_time;
+}
+
+void aux_set_contact_time(aux_t *aux, double time) {
+    assert(0 <= time && time <= 1);
+    aux->contact_time = time;
+}
@@ -0,0 +1,231 @@
+#include "nbody.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Points closer than the smallest cell at this depth share a leaf
+#define NBODY_MAX_DEPTH 48
+// A depth-first walk holds at most three siblings per level plus the current node
+#define NBODY_STACK_SIZE (3 * NBODY_MAX_DEPTH + 4)
+
+// Leaf markers stored in quad_node_t.point
+const long NBODY_INTERNAL = -1;
+const long NBODY_BUCKET = -2;
+
+typedef struct {
+    // Center and half the width of the square covered by the node
+    double cx;
+    double cy;
+    double half;
+    // Total mass, and the mass-weighted position sums until finished
+    double mass;
+    double mx;
+    double my;
+    size_t count;
+    // The only point in a leaf, or NBODY_INTERNAL / NBODY_BUCKET
+    long point;
+    long children[4];
+} quad_node_t;
+
+typedef struct {
+    quad_node_t *nodes;
+    size_t size;
+    size_t capacity;
+} quadtree_t;
+
+void nbody_pairwise_forces(
+    size_t n,
+    const double *x,
+    const double *y,
+    const double *mass,
+    double G,
+    double min_distance,
+    double *fx,
+    double *fy
+){
+    double min_squared = min_distance * min_distance;
+    for (size_t i = 0; i < n; i++) {
+        double xi = x[i], yi = y[i], gmi = G * mass[i];
+        double fxi = 0, fyi = 0;
+        // Each pair is visited once, so accumulate the reaction on j as we go
+        for (size_t j = i + 1; j < n; j++) {
+            double dx = x[j] - xi;
+            double dy = y[j] - yi;
+            double squared = dx * dx + dy * dy;
+            if (squared < min_squared) {
+                continue;
+            }
+            // G m_i m_j / d^2 along the unit vector (dx, dy) / d
+            double inverse = 1 / sqrt(squared);
+            double scale = gmi * mass[j] * inverse * inverse * inverse;
+            fxi += scale * dx;
+            fyi += scale * dy;
+            fx[j] -= scale * dx;
+            fy[j] -= scale * dy;
+        }
+        fx[i] += fxi;
+        fy[i] += fyi;
+    }
+}
+
+static long quadtree_add_node(quadtree_t *tree, double cx, double cy, double half) {
+    if (tree->size == tree->capacity) {
+        tree->capacity *= 2;
+        tree->nodes = realloc(tree->nodes, tree->capacity * sizeof(quad_node_t));
+        assert(tree->nodes != NULL && "Could not grow the Barnes-Hut quadtree.");
+    }
+    tree->nodes[tree->size] = (quad_node_t) {
+        cx, cy, half, 0, 0, 0, 0, NBODY_INTERNAL, {-1, -1, -1, -1}
+    };
+    return tree->size++;
+}
+
+static size_t quadrant(quad_node_t *node, double x, double y) {
+    return (x >= node->cx) | ((y >= node->cy) << 1);
+}
+
+/**
+ * Gets the child of a node covering a quadrant, creating it if needed.
+ */
+static long quadtree_child(quadtree_t *tree, long index, size_t quad) {
+    long child = tree->nodes[index].children[quad];
+    if (child == -1) {
+        quad_node_t *node = &tree->nodes[index];
+        double half = node->half / 2;
+        double cx = node->cx + (quad & 1 ? half : -half);
+        double cy = node->cy + (quad & 2 ? half : -half);
+        child = quadtree_add_node(tree, cx, cy, half);
+        tree->nodes[index].children[quad] = child;
+    }
+    return child;
+}
+
+static void quadtree_add_mass(quad_node_t *node, double x, double y, double mass) {
+    node->mass += mass;
+    node->mx += mass * x;
+    node->my += mass * y;
+    node->count++;
+}
+
+static void quadtree_insert(quadtree_t *tree, const double *x, const double *y,
+                            const double *mass, long point) {
+    long index = 0;
+    for (size_t depth = 0; ; depth++) {
+        quad_node_t *node = &tree->nodes[index];
+        if (node->count == 0) {
+            quadtree_add_mass(node, x[point], y[point], mass[point]);
+            node->point = point;
+            return;
+        }
+        quadtree_add_mass(node, x[point], y[point], mass[point]);
+        if (node->point == NBODY_BUCKET) {
+            return;
+        }
+        if (node->point != NBODY_INTERNAL) {
+            if (depth == NBODY_MAX_DEPTH) {
+                node->point = NBODY_BUCKET;
+                return;
+            }
+            // Push the leaf's point down so this node can be split
+            long other = node->point;
+            node->point = NBODY_INTERNAL;
+            long child = quadtree_child(tree, index, quadrant(node, x[other], y[other]));
+            quadtree_add_mass(&tree->nodes[child], x[other], y[other], mass[other]);
+            tree->nodes[child].point = other;
+            node = &tree->nodes[index];
+        }
+        index = quadtree_child(tree, index, quadrant(node, x[point], y[point]));
+    }
+}
+
+/**
+ * Builds a quadtree over every point and turns the mass-weighted position
+ * sums into centers of mass.
+ */
+static void quadtree_build(quadtree_t *tree, size_t n, const double *x, const double *y,
+                           const double *mass) {
+    double min_x = x[0], max_x = x[0], min_y = y[0], max_y = y[0];
+    for (size_t i = 1; i < n; i++) {
+        min_x = fmin(min_x, x[i]);
+        max_x = fmax(max_x, x[i]);
+        min_y = fmin(min_y, y[i]);
+        max_y = fmax(max_y, y[i]);
+    }
+    // Pad the root so points on the maximum edge still fall inside it
+    double half = fmax(max_x - min_x, max_y - min_y) / 2 * 1.0001 + 1e-9;
+    quadtree_add_node(tree, (min_x + max_x) / 2, (min_y + max_y) / 2, half);
+    for (size_t i = 0; i < n; i++) {
+        quadtree_insert(tree, x, y, mass, i);
+    }
+    for (size_t i = 0; i < tree->size; i++) {
+        quad_node_t *node = &tree->nodes[i];
+        if (node->mass != 0) {
+            node->mx /= node->mass;
+            node->my /= node->mass;
+        }
+    }
+}
+
+static bool quadtree_node_contains(quad_node_t *node, double x, double y) {
+    return fabs(x - node->cx) <= node->half && fabs(y - node->cy) <= node->half;
+}
+
+void nbody_barnes_hut_forces(
+    size_t n,
+    const double *x,
+    const double *y,
+    const double *mass,
+    double G,
+    double min_distance,
+    double theta,
+    double *fx,
+    double *fy
+){
+    if (n < 2) {
+        return;
+    }
+    quadtree_t tree = {malloc(2 * n * sizeof(quad_node_t)), 0, 2 * n};
+    assert(tree.nodes != NULL && "Could not allocate the Barnes-Hut quadtree.");
+    quadtree_build(&tree, n, x, y, mass);
+
+    double min_squared = min_distance * min_distance;
+    double theta_squared = theta * theta;
+    long stack[NBODY_STACK_SIZE];
+    for (size_t i = 0; i < n; i++) {
+        double xi = x[i], yi = y[i], gmi = G * mass[i];
+        double fxi = 0, fyi = 0;
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            quad_node_t *node = &tree.nodes[stack[--top]];
+            if (node->point == (long) i) {
+                continue;
+            }
+            double dx = node->mx - xi;
+            double dy = node->my - yi;
+            double squared = dx * dx + dy * dy;
+            double width = 2 * node->half;
+            // A group is only approximated when the point lies outside of it
+            bool far = width * width < theta_squared * squared
+                && !quadtree_node_contains(node, xi, yi);
+            if (node->point != NBODY_INTERNAL || far) {
+                if (squared >= min_squared) {
+                    double inverse = 1 / sqrt(squared);
+                    double scale = gmi * node->mass * inverse * inverse * inverse;
+                    fxi += scale * dx;
+                    fyi += scale * dy;
+                }
+                continue;
+            }
+            for (size_t quad = 0; quad < 4; quad++) {
+                if (node->children[quad] != -1) {
+                    stack[top++] = node->children[quad];
+                }
+            }
+        }
+        fx[i] += fxi;
+        fy[i] += fyi;
+    }
+    free(tree.nodes);
+}
@@ -1,11 +1,17 @@
 #include "vector.h"
 #include "list.h"
 #include "color.h"
+#include "polygon.h"
 #include <math.h>
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
 
+#ifndef _WIN32
+#include <pthread.h>
+#define POLYGON_HAS_THREADS
+#endif
+
 /**
  * Computes the summations of the shoelace formula
  * 
@@ -68,3 +74,365 @@ void polygon_rotate(list_t *polygon, double angle, vector_t point) {
             *vec = vec_add(*vec, point);
     }
 }
+
+bounding_box_t polygon_bounding_box(list_t *polygon) {
+    vector_t *first = (vector_t *) list_get(polygon, 0);
+    bounding_box_t box = {*first, *first};
+    for (size_t i = 1; i < list_size(polygon); i++) {
+        vector_t *vec = (vector_t *) list_get(polygon, i);
+        box.min.x = fmin(box.min.x, vec->x);
+        box.min.y = fmin(box.min.y, vec->y);
+        box.max.x = fmax(box.max.x, vec->x);
+        box.max.y = fmax(box.max.y, vec->y);
+    }
+    return box;
+}
+
+bounding_box_t polygon_points_bounding_box(const vector_t *points, size_t size) {
+    assert(size > 0);
+    bounding_box_t box = {points[0], points[0]};
+    for (size_t i = 1; i < size; i++) {
+        box.min.x = fmin(box.min.x, points[i].x);
+        box.min.y = fmin(box.min.y, points[i].y);
+        box.max.x = fmax(box.max.x, points[i].x);
+        box.max.y = fmax(box.max.y, points[i].y);
+    }
+    return box;
+}
+
+double polygon_points_area(const vector_t *points, size_t size) {
+    double ret = 0;
+    for (size_t i = 0; i < size; i++) {
+        vector_t next = points[(i + 1) % size];
+        ret += points[i].x * next.y - next.x * points[i].y;
+    }
+    return 0.5 * fabs(ret);
+}
+
+vector_t polygon_points_centroid(const vector_t *points, size_t size) {
+    double centroid_x = 0.0;
+    double centroid_y = 0.0;
+    for (size_t i = 0; i < size; i++) {
+        vector_t current = points[i];
+        vector_t next = points[(i + 1) % size];
+        double second_part = vec_cross(current, next);
+        centroid_x += (current.x + next.x) * second_part;
+        centroid_y += (current.y + next.y) * second_part;
+    }
+
+    double divisor = 6.0 * polygon_points_area(points, size);
+    vector_t answer = {fabs(centroid_x / divisor), fabs(centroid_y / divisor)};
+    return answer;
+}
+
+/*
+ * Kernels behind polygon_points_translate(), polygon_points_transform() and
+ * polygon_points_project(). Each has a scalar version and, on x86-64,
+ * SSE2 and AVX versions chosen at runtime from what the CPU supports.
+ * The vector versions do the same multiplications and additions in the same
+ * order as the scalar ones, so every version gives bit-identical results.
+ */
+
+// Projections start from these bounds, so an empty polygon keeps them
+// and any vertex, however far away, replaces them
+const double PROJECT_MIN_START = INFINITY;
+const double PROJECT_MAX_START = -INFINITY;
+
+typedef void (*translate_kernel_t)(const vector_t *, vector_t *, size_t, vector_t);
+typedef void (*transform_kernel_t)(const vector_t *, vector_t *, size_t, vector_t, double, double);
+typedef void (*project_kernel_t)(const vector_t *, size_t, vector_t, double *, double *);
+
+static void translate_scalar(const vector_t *src, vector_t *dst, size_t size, vector_t offset) {
+    for (size_t i = 0; i < size; i++) {
+        dst[i] = vec_add(src[i], offset);
+    }
+}
+
+static void transform_scalar(const vector_t *local, vector_t *world, size_t size,
+                             vector_t position, double cos_angle, double sin_angle) {
+    for (size_t i = 0; i < size; i++) {
+        world[i] = (vector_t) {
+            local[i].x * cos_angle - local[i].y * sin_angle + position.x,
+            local[i].x * sin_angle + local[i].y * cos_angle + position.y
+        };
+    }
+}
+
+static void project_scalar(const vector_t *points, size_t size, vector_t axis,
+                           double *min, double *max) {
+    double min_val = PROJECT_MIN_START;
+    double max_val = PROJECT_MAX_START;
+    for (size_t i = 0; i < size; i++) {
+        double val = points[i].x * axis.x + points[i].y * axis.y;
+        if (val < min_val) {
+            min_val = val;
+        }
+        if (val > max_val) {
+            max_val = val;
+        }
+    }
+    *min = min_val;
+    *max = max_val;
+}
+
+#ifdef __x86_64__
+#include <immintrin.h>
+
+// vector_t is two adjacent doubles, so one SSE2 register holds one vertex.
+// The SSE2 kernels also finish the AVX kernels' last few vertices; inlining
+// them there keeps the AVX code free of slow switches to non-AVX encodings.
+#define SSE2_KERNEL static inline __attribute__((always_inline))
+
+SSE2_KERNEL void translate_sse2(const vector_t *src, vector_t *dst, size_t size, vector_t offset) {
+    __m128d add = _mm_set_pd(offset.y, offset.x);
+    for (size_t i = 0; i < size; i++) {
+        _mm_storeu_pd(&dst[i].x, _mm_add_pd(_mm_loadu_pd(&src[i].x), add));
+    }
+}
+
+SSE2_KERNEL void transform_sse2(const vector_t *local, vector_t *world, size_t size,
+                           vector_t position, double cos_angle, double sin_angle) {
+    // (x, x) * (cos, sin) + (y, y) * (-sin, cos) + position
+    __m128d x_factors = _mm_set_pd(sin_angle, cos_angle);
+    __m128d y_factors = _mm_set_pd(cos_angle, -sin_angle);
+    __m128d add = _mm_set_pd(position.y, position.x);
+    for (size_t i = 0; i < size; i++) {
+        __m128d point = _mm_loadu_pd(&local[i].x);
+        __m128d x = _mm_unpacklo_pd(point, point);
+        __m128d y = _mm_unpackhi_pd(point, point);
+        __m128d rotated = _mm_add_pd(_mm_mul_pd(x, x_factors), _mm_mul_pd(y, y_factors));
+        _mm_storeu_pd(&world[i].x, _mm_add_pd(rotated, add));
+    }
+}
+
+/**
+ * Folds the projections of some vertices into running minimums and maximums
+ * held in both halves of min_vals and max_vals.
+ */
+SSE2_KERNEL void project_sse2_accumulate(const vector_t *points, size_t size, vector_t axis,
+                                         __m128d *min_vals, __m128d *max_vals) {
+    __m128d axis_x = _mm_set1_pd(axis.x), axis_y = _mm_set1_pd(axis.y);
+    size_t i = 0;
+    // Two vertices at a time, split into (x0, x1) and (y0, y1)
+    for (; i + 2 <= size; i += 2) {
+        __m128d point0 = _mm_loadu_pd(&points[i].x);
+        __m128d point1 = _mm_loadu_pd(&points[i + 1].x);
+        __m128d x = _mm_unpacklo_pd(point0, point1);
+        __m128d y = _mm_unpackhi_pd(point0, point1);
+        __m128d vals = _mm_add_pd(_mm_mul_pd(x, axis_x), _mm_mul_pd(y, axis_y));
+        *min_vals = _mm_min_pd(*min_vals, vals);
+        *max_vals = _mm_max_pd(*max_vals, vals);
+    }
+    if (i < size) {
+        __m128d vals = _mm_set1_pd(points[i].x * axis.x + points[i].y * axis.y);
+        *min_vals = _mm_min_pd(*min_vals, vals);
+        *max_vals = _mm_max_pd(*max_vals, vals);
+    }
+}
+
+/**
+ * Writes out the smaller and larger halves of the running extremes.
+ */
+SSE2_KERNEL void project_sse2_finish(__m128d min_vals, __m128d max_vals,
+                                     double *min, double *max) {
+    *min = _mm_cvtsd_f64(_mm_min_sd(min_vals, _mm_unpackhi_pd(min_vals, min_vals)));
+    *max = _mm_cvtsd_f64(_mm_max_sd(max_vals, _mm_unpackhi_pd(max_vals, max_vals)));
+}
+
+SSE2_KERNEL void project_sse2(const vector_t *points, size_t size, vector_t axis,
+                              double *min, double *max) {
+    __m128d min_vals = _mm_set1_pd(PROJECT_MIN_START);
+    __m128d max_vals = _mm_set1_pd(PROJECT_MAX_START);
+    project_sse2_accumulate(points, size, axis, &min_vals, &max_vals);
+    project_sse2_finish(min_vals, max_vals, min, max);
+}
+
+// Doubles only need AVX, not AVX2; one register holds two vertices
+__attribute__((target("avx")))
+static void translate_avx(const vector_t *src, vector_t *dst, size_t size, vector_t offset) {
+    __m256d add = _mm256_set_pd(offset.y, offset.x, offset.y, offset.x);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256d points01 = _mm256_loadu_pd(&src[i].x);
+        __m256d points23 = _mm256_loadu_pd(&src[i + 2].x);
+        _mm256_storeu_pd(&dst[i].x, _mm256_add_pd(points01, add));
+        _mm256_storeu_pd(&dst[i + 2].x, _mm256_add_pd(points23, add));
+    }
+    translate_sse2(src + i, dst + i, size - i, offset);
+}
+
+__attribute__((target("avx")))
+static inline __m256d rotate_avx(__m256d points, __m256d x_factors, __m256d y_factors,
+                                 __m256d add) {
+    __m256d x = _mm256_movedup_pd(points);
+    __m256d y = _mm256_permute_pd(points, 0xF);
+    __m256d rotated = _mm256_add_pd(_mm256_mul_pd(x, x_factors), _mm256_mul_pd(y, y_factors));
+    return _mm256_add_pd(rotated, add);
+}
+
+__attribute__((target("avx")))
+static void transform_avx(const vector_t *local, vector_t *world, size_t size,
+                          vector_t position, double cos_angle, double sin_angle) {
+    __m256d x_factors = _mm256_set_pd(sin_angle, cos_angle, sin_angle, cos_angle);
+    __m256d y_factors = _mm256_set_pd(cos_angle, -sin_angle, cos_angle, -sin_angle);
+    __m256d add = _mm256_set_pd(position.y, position.x, position.y, position.x);
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m256d points01 = _mm256_loadu_pd(&local[i].x);
+        __m256d points23 = _mm256_loadu_pd(&local[i + 2].x);
+        _mm256_storeu_pd(&world[i].x, rotate_avx(points01, x_factors, y_factors, add));
+        _mm256_storeu_pd(&world[i + 2].x, rotate_avx(points23, x_factors, y_factors, add));
+    }
+    transform_sse2(local + i, world + i, size - i, position, cos_angle, sin_angle);
+}
+
+__attribute__((target("avx")))
+static void project_avx(const vector_t *points, size_t size, vector_t axis,
+                        double *min, double *max) {
+    __m256d axis_x = _mm256_set1_pd(axis.x), axis_y = _mm256_set1_pd(axis.y);
+    __m256d min_vals = _mm256_set1_pd(PROJECT_MIN_START);
+    __m256d max_vals = _mm256_set1_pd(PROJECT_MAX_START);
+    size_t i = 0;
+    // Four vertices at a time, split into (x0, x2, x1, x3) and (y0, y2, y1, y3)
+    for (; i + 4 <= size; i += 4) {
+        __m256d points01 = _mm256_loadu_pd(&points[i].x);
+        __m256d points23 = _mm256_loadu_pd(&points[i + 2].x);
+        __m256d x = _mm256_unpacklo_pd(points01, points23);
+        __m256d y = _mm256_unpackhi_pd(points01, points23);
+        __m256d vals = _mm256_add_pd(_mm256_mul_pd(x, axis_x), _mm256_mul_pd(y, axis_y));
+        min_vals = _mm256_min_pd(min_vals, vals);
+        max_vals = _mm256_max_pd(max_vals, vals);
+    }
+    __m128d min_pairs = _mm_min_pd(_mm256_castpd256_pd128(min_vals),
+                                   _mm256_extractf128_pd(min_vals, 1));
+    __m128d max_pairs = _mm_max_pd(_mm256_castpd256_pd128(max_vals),
+                                   _mm256_extractf128_pd(max_vals, 1));
+    project_sse2_accumulate(points + i, size - i, axis, &min_pairs, &max_pairs);
+    project_sse2_finish(min_pairs, max_pairs, min, max);
+}
+#endif // #ifdef __x86_64__
+
+static polygon_kernels_t kernels = POLYGON_KERNELS_SCALAR;
+#ifdef POLYGON_HAS_THREADS
+// The kernels are first used from thread pool workers, so they are picked exactly once
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+#else
+static bool kernels_selected = false;
+#endif
+static translate_kernel_t translate_kernel = translate_scalar;
+static transform_kernel_t transform_kernel = transform_scalar;
+static project_kernel_t project_kernel = project_scalar;
+
+static polygon_kernels_t best_kernels(void) {
+#ifdef __x86_64__
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+        return POLYGON_KERNELS_AVX;
+    }
+    return POLYGON_KERNELS_SSE2;
+#else
+    return POLYGON_KERNELS_SCALAR;
+#endif
+}
+
+/**
+ * Points the kernel functions at the given implementation.
+ */
+static void use_kernels(polygon_kernels_t chosen) {
+    kernels = chosen;
+    translate_kernel = translate_scalar;
+    transform_kernel = transform_scalar;
+    project_kernel = project_scalar;
+#ifdef __x86_64__
+    if (kernels == POLYGON_KERNELS_SSE2) {
+        translate_kernel = translate_sse2;
+        transform_kernel = transform_sse2;
+        project_kernel = project_sse2;
+    }
+    else if (kernels == POLYGON_KERNELS_AVX) {
+        translate_kernel = translate_avx;
+        transform_kernel = transform_avx;
+        project_kernel = project_avx;
+    }
+#endif
+}
+
+static void use_best_kernels(void) {
+    use_kernels(best_kernels());
+}
+
+/**
+ * Picks the fastest kernels the CPU supports the first time one is needed.
+ */
+static void select_kernels(void) {
+#ifdef POLYGON_HAS_THREADS
+    pthread_once(&kernels_once, use_best_kernels);
+#else
+    if (!kernels_selected) {
+        kernels_selected = true;
+        use_best_kernels();
+    }
+#endif
+}
+
+polygon_kernels_t polygon_set_kernels(polygon_kernels_t requested) {
+    // Pick the defaults first so that they cannot replace the requested kernels later
+    select_kernels();
+    polygon_kernels_t best = best_kernels();
+    use_kernels(requested < best ? requested : best);
+    return kernels;
+}
+
+polygon_kernels_t polygon_get_kernels(void) {
+    select_kernels();
+    return kernels;
+}
+
+void polygon_points_translate(vector_t *points, size_t size, vector_t translation) {
+    select_kernels();
+    translate_kernel(points, points, size, translation);
+}
+
+void polygon_points_rotate(vector_t *points, size_t size, double angle, vector_t point) {
+    // Same arithmetic as vec_rotate(), with the trigonometry hoisted out of the loop
+    double cos_angle = cos(angle), sin_angle = sin(angle);
+    for (size_t i = 0; i < size; i++) {
+        vector_t offset = vec_subtract(points[i], point);
+        vector_t rotated = {
+            offset.x * cos_angle - offset.y * sin_angle,
+            offset.x * sin_angle + offset.y * cos_angle
+        };
+        points[i] = vec_add(rotated, point);
+    }
+}
+
+void polygon_points_transform(
+    const vector_t *local,
+    vector_t *world,
+    size_t size,
+    vector_t position,
+    double angle
+) {
+    select_kernels();
+    if (angle == 0.0) {
+        translate_kernel(local, world, size, position);
+        return;
+    }
+    transform_kernel(local, world, size, position, cos(angle), sin(angle));
+}
+
+void polygon_points_project(
+    const vector_t *points,
+    size_t size,
+    vector_t axis,
+    double *min,
+    double *max
+) {
+    select_kernels();
+    project_kernel(points, size, axis, min, max);
+}
+
+bool bounding_box_overlap(bounding_box_t box1, bounding_box_t box2) {
+    return box1.min.x < box2.max.x && box2.min.x < box1.max.x
+        && box1.min.y < box2.max.y && box2.min.y < box1.max.y;
+}
@@ -1,18 +1,39 @@
 #include "list.h"
 #include "body.h"
 #include "my_aux.h"
+#include "collision.h"
 #include "scene.h"
 #include "image.h"
+#include "spatial_hash.h"
+#include "thread_pool.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <limits.h>
+
+// Width of a broad phase grid cell, roughly the size of a typical level wall
+const double BROAD_PHASE_CELL_SIZE = 100.0;
+// Fewer pure force creators or collision detectors than this
+// are cheaper to run on one thread
+const size_t SCENE_MIN_PARALLEL_FORCES = 64;
+// Fewer dynamic bodies than this are cheaper to integrate on one thread
+const size_t SCENE_MIN_PARALLEL_BODIES = 1024;
 
 typedef struct force {
     force_creator_t forcer;
+    // Tests for a collision before forcer runs; see scene_add_collision_force_creator()
+    force_creator_t detector;
     list_t *bodies;
     aux_t *aux;
     free_func_t free_func;
+    bool is_collision;
+    bool candidate_last_tick;
+    bool removed;
+    // Whether the force creator may run on any thread; see scene_add_pure_force_creator()
+    bool is_pure;
+    // Whether the force creator runs this tick, decided once before any run
+    bool runs_this_tick;
 }force_t;
 
 typedef struct scene {
@@ -26,14 +47,49 @@ typedef struct scene {
     bool clicked;
     void *extra_info;
     free_func_t extra_info_freer;
+    // Holds the dynamic bodies each tick, paired with each other and with static_phase
+    spatial_hash_t *broad_phase;
+    size_t num_collisions;
+    // Holds the static and sleeping bodies with collision forces,
+    // rebuilt only when one is added, removed or moved
+    spatial_hash_t *static_phase;
+    bool static_phase_stale;
+    // Finds the bodies along a ray for scene_raycast(), rebuilt when stale
+    spatial_hash_t *query_index;
+    list_t *query_candidates;
+    bool query_index_stale;
+    // Bodies integrated every tick; static and sleeping bodies are only in bodies
+    list_t *dynamic_bodies;
+    // Static or sleeping bodies that woke up since the last tick
+    list_t *woken_bodies;
+    // For each tag, the bodies with that tag in the order they were added,
+    // or NULL if no body with the tag has been added
+    list_t *tagged_bodies[UCHAR_MAX + 1];
+    // Whether scene_remove_force() was called since the last sweep
+    bool forces_removed;
+    // Runs pure force creators when scene_set_threads() asked for more than one thread
+    thread_pool_t *pool;
+    // One force buffer per pool thread, applied in order after the parallel phase
+    body_force_buffer_t **force_buffers;
+    // The pure force creators or collision detectors to run this tick
+    force_t **parallel_forces;
+    size_t num_parallel_forces;
+    size_t parallel_forces_capacity;
 } scene_t;
 
 force_t *force_init(force_creator_t forcer, list_t *bodies, aux_t *aux, free_func_t freer) {
     force_t *force = malloc(sizeof(force_t));
     force->forcer = forcer;
+    force->detector = NULL;
     force->bodies = bodies;
     force->aux = aux;
     force->free_func = freer;
+    force->is_collision = false;
+    // Unknown until the first broad phase, so always run the first tick
+    force->candidate_last_tick = true;
+    force->removed = false;
+    force->is_pure = false;
+    force->runs_this_tick = false;
     return force;
 }
 
@@ -69,6 +125,24 @@ scene_t *scene_init(void) {
     scene->pause = false;
     scene->clicked = false;
     scene->extra_info_freer = NULL;
+    scene->broad_phase = spatial_hash_init(BROAD_PHASE_CELL_SIZE);
+    scene->num_collisions = 0;
+    scene->static_phase = spatial_hash_init(BROAD_PHASE_CELL_SIZE);
+    scene->static_phase_stale = true;
+    scene->query_index = spatial_hash_init(BROAD_PHASE_CELL_SIZE);
+    scene->query_candidates = list_init(8, NULL);
+    scene->query_index_stale = true;
+    scene->dynamic_bodies = list_init(10, NULL);
+    scene->woken_bodies = list_init(10, NULL);
+    for (size_t i = 0; i <= UCHAR_MAX; i++) {
+        scene->tagged_bodies[i] = NULL;
+    }
+    scene->forces_removed = false;
+    scene->pool = NULL;
+    scene->force_buffers = NULL;
+    scene->parallel_forces = NULL;
+    scene->num_parallel_forces = 0;
+    scene->parallel_forces_capacity = 0;
     return scene;
 }
 
@@ -82,6 +156,19 @@ void scene_free(scene_t *scene) {
     if(scene->extra_info_freer != NULL){
         scene->extra_info_freer(scene->extra_info);
     }
+    spatial_hash_free(scene->broad_phase);
+    spatial_hash_free(scene->static_phase);
+    spatial_hash_free(scene->query_index);
+    list_free(scene->query_candidates);
+    list_free(scene->dynamic_bodies);
+    list_free(scene->woken_bodies);
+    for (size_t i = 0; i <= UCHAR_MAX; i++) {
+        if (scene->tagged_bodies[i] != NULL) {
+            list_free(scene->tagged_bodies[i]);
+        }
+    }
+    scene_set_threads(scene, 1);
+    free(scene->parallel_forces);
     free(scene);
 }
 
@@ -105,6 +192,42 @@ void scene_set_extra_info(scene_t *scene, void *info, free_func_t freer){
 void scene_add_body(scene_t *scene, body_t *body) {
     list_add(scene->bodies, body);
     scene->size++;
+    scene->query_index_stale = true;
+    char tag = body_get_tag(body);
+    if (tag != BODY_NO_TAG) {
+        list_t **tagged = &scene->tagged_bodies[(unsigned char) tag];
+        if (*tagged == NULL) {
+            *tagged = list_init(4, NULL);
+        }
+        list_add(*tagged, body);
+    }
+    if (body_get_motion(body) == BODY_DYNAMIC) {
+        list_add(scene->dynamic_bodies, body);
+    }
+    else {
+        body_deactivate(body, body_get_motion(body), scene->woken_bodies);
+    }
+}
+
+body_t *scene_get_tagged(scene_t *scene, char tag) {
+    list_t *tagged = scene_get_tagged_bodies(scene, tag);
+    if (list_size(tagged) == 0) {
+        return NULL;
+    }
+    return list_get(tagged, list_size(tagged) - 1);
+}
+
+list_t *scene_get_tagged_bodies(scene_t *scene, char tag) {
+    assert(tag != BODY_NO_TAG);
+    list_t **tagged = &scene->tagged_bodies[(unsigned char) tag];
+    if (*tagged == NULL) {
+        *tagged = list_init(4, NULL);
+    }
+    return *tagged;
+}
+
+size_t scene_dynamic_bodies(scene_t *scene) {
+    return list_size(scene->dynamic_bodies);
 }
 
 void scene_remove_body(scene_t *scene, size_t index) {
@@ -147,10 +270,93 @@ bool scene_show_text_image(scene_t *scene, size_t index) {
     return image_get_show(list_get(scene->text_images, index));
 }
 
+/**
+ * Removes a body from a list of bodies that do not own it, if it is there.
+ *
+ * @return whether the body was in the list
+ */
+bool remove_body_reference(list_t *bodies, body_t *body) {
+    int index = list_index_of(bodies, body);
+    if (index == -1) {
+        return false;
+    }
+    list_remove(bodies, index);
+    return true;
+}
+
+/**
+ * Records a force on each of its bodies, so removing a body can find
+ * the forces acting on it without scanning every force in the scene.
+ */
+void index_force(force_t *force) {
+    for (size_t i = 0; i < list_size(force->bodies); i++) {
+        list_add(body_get_force_creators(list_get(force->bodies, i)), force);
+    }
+}
+
+/**
+ * Marks a force as removed and drops it from the force lists of the bodies
+ * it acts on that are still alive. Removed bodies are skipped, since their
+ * lists are freed with them. The force itself is freed by the next sweep.
+ */
+void unindex_force(scene_t *scene, force_t *force) {
+    if (force->removed) {
+        return;
+    }
+    force->removed = true;
+    scene->forces_removed = true;
+    for (size_t i = 0; i < list_size(force->bodies); i++) {
+        body_t *body = list_get(force->bodies, i);
+        if (!body_is_removed(body)) {
+            list_t *forces = body_get_force_creators(body);
+            list_remove(forces, list_index_of(forces, force));
+        }
+    }
+}
+
+/**
+ * Removes every force acting on a removed body.
+ */
+void unindex_body_forces(scene_t *scene, body_t *body) {
+    list_t *forces = body_get_force_creators(body);
+    for (size_t i = 0; i < list_size(forces); i++) {
+        unindex_force(scene, list_get(forces, i));
+    }
+}
+
+/**
+ * Returns whether a body has a collision force that was not removed,
+ * which is the only way the broad phase can matter to it.
+ */
+bool has_collisions(body_t *body) {
+    list_t *forces = body_get_force_creators(body);
+    for (size_t i = 0; i < list_size(forces); i++) {
+        force_t *force = list_get(forces, i);
+        if (force->is_collision && !force->removed) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void scene_remove_body_extra(scene_t *scene, size_t index){
     body_t *removed = list_remove(scene->bodies, index);
+    bool collides = has_collisions(removed);
+    // Its forces must not outlive it, since they are swept after it is freed
+    body_remove(removed);
+    unindex_body_forces(scene, removed);
+    remove_body_reference(scene->dynamic_bodies, removed);
+    // Woken bodies are still in the static grid until the next tick
+    bool was_woken = remove_body_reference(scene->woken_bodies, removed);
+    if (collides && (was_woken || body_get_motion(removed) != BODY_DYNAMIC)) {
+        scene->static_phase_stale = true;
+    }
+    if (body_get_tag(removed) != BODY_NO_TAG) {
+        remove_body_reference(scene_get_tagged_bodies(scene, body_get_tag(removed)), removed);
+    }
     body_free(removed);
     scene->size--;
+    scene->query_index_stale = true;
 }
 
 void scene_add_force_creator(scene_t *scene, force_creator_t forcer, void *aux, free_func_t freer) {
@@ -174,55 +380,473 @@ void scene_add_bodies_force_creator(
 ){
     force_t *force = force_init(forcer, bodies, aux, freer);
     list_add(scene->forces, force);
+    index_force(force);
+}
+
+void scene_add_collision_force_creator(
+    scene_t *scene,
+    force_creator_t detector,
+    force_creator_t forcer,
+    void *aux,
+    list_t *bodies,
+    free_func_t freer
+){
+    assert(list_size(bodies) == 2 && "A collision force creator needs exactly two bodies!");
+    force_t *force = force_init(forcer, bodies, aux, freer);
+    force->is_collision = true;
+    force->detector = detector;
+    list_add(scene->forces, force);
+    index_force(force);
+    scene->num_collisions++;
+    for (size_t i = 0; i < list_size(bodies); i++) {
+        if (body_get_motion(list_get(bodies, i)) != BODY_DYNAMIC) {
+            scene->static_phase_stale = true;
+        }
+    }
 }
 
 list_t *scene_get_forces(scene_t *scene){
     return scene->forces;
 }
 
-void scene_tick(scene_t *scene, double dt) {
-    if (! scene->pause) { 
-        list_t *forces = scene->forces;
-
-        //tick non collisions
-        // for(size_t i = 0; i < list_size(forces); i++){
-        //     force_t *force = list_get(forces, i);
-        //     aux_t *aux = force->aux;
-        
-        // }
-
-        for (size_t i = 0; i < list_size(forces); i++) {
-            force_t *force = list_get(forces, i);
-            aux_t *aux = force->aux;
-            force->forcer(aux);
-        }
-
-        for (size_t i = 0; i < list_size(forces); i++) {
-            force_t *force = list_get(forces, i);
-            for(size_t j = 0; j < list_size(force->bodies); j++){
-                if(body_is_removed(list_get(force->bodies, j))){
-                    force_t *removed = list_remove(scene->forces, i);
-                    i--;
-                    force_free(removed);
-                    break;
-                }
+void scene_add_pure_force_creator(
+    scene_t *scene,
+    force_creator_t forcer,
+    void *aux,
+    list_t *bodies,
+    free_func_t freer
+){
+    scene_add_bodies_force_creator(scene, forcer, aux, bodies, freer);
+    force_t *force = list_get(scene->forces, list_size(scene->forces) - 1);
+    force->is_pure = true;
+}
+
+void scene_set_threads(scene_t *scene, size_t threads) {
+    if (scene->pool != NULL) {
+        for (size_t i = 0; i < thread_pool_size(scene->pool); i++) {
+            body_force_buffer_free(scene->force_buffers[i]);
+        }
+        free(scene->force_buffers);
+        thread_pool_free(scene->pool);
+        scene->pool = NULL;
+        scene->force_buffers = NULL;
+    }
+    if (threads <= 1) {
+        return;
+    }
+    scene->pool = thread_pool_init(threads);
+    size_t size = thread_pool_size(scene->pool);
+    scene->force_buffers = malloc(sizeof(body_force_buffer_t *) * size);
+    assert(scene->force_buffers != NULL && "Could not allocate memory for force buffers.");
+    for (size_t i = 0; i < size; i++) {
+        scene->force_buffers[i] = body_force_buffer_init();
+    }
+}
+
+void scene_remove_force(scene_t *scene, force_t *force) {
+    unindex_force(scene, force);
+}
+
+/**
+ * Inserts each body of a list that has a collision force into the broad phase grid.
+ */
+void insert_moving_bodies(spatial_hash_t *hash, list_t *bodies) {
+    for (size_t i = 0; i < list_size(bodies); i++) {
+        body_t *body = list_get(bodies, i);
+        if (!has_collisions(body)) {
+            continue;
+        }
+        // Bullets are paired with everything along their path, not just where they stopped
+        bounding_box_t box = body_is_bullet(body)
+            ? body_get_swept_bounding_box(body) : body_get_bounding_box(body);
+        spatial_hash_insert(hash, body, box);
+    }
+}
+
+/**
+ * Finds all pairs of bodies whose boxes overlap and at least one of which
+ * is moving. Only the dynamic and woken bodies are inserted each tick;
+ * static and sleeping bodies stay in their own grid until one of them
+ * is added, removed or moved, since two bodies that are not moving
+ * cannot start overlapping. Bodies without collision forces, like
+ * decorations, are left out of both, since no force asks about them.
+ */
+void scene_update_broad_phase(scene_t *scene) {
+    if (scene->static_phase_stale) {
+        spatial_hash_clear(scene->static_phase);
+        for (size_t i = 0; i < scene->size; i++) {
+            body_t *body = list_get(scene->bodies, i);
+            if (body_get_motion(body) != BODY_DYNAMIC && has_collisions(body)) {
+                spatial_hash_insert(scene->static_phase, body, body_get_bounding_box(body));
             }
         }
-        
-        for(size_t i = 0; i < scene->size; i++){
-            body_tick(list_get(scene->bodies, i), dt);
-            if(body_is_removed(list_get(scene->bodies, i))){
-                scene_remove_body_extra(scene, i);
-                i--;
+        scene->static_phase_stale = false;
+    }
+
+    spatial_hash_t *hash = scene->broad_phase;
+    spatial_hash_clear(hash);
+    insert_moving_bodies(hash, scene->dynamic_bodies);
+    insert_moving_bodies(hash, scene->woken_bodies);
+    spatial_hash_find_pairs(hash);
+    spatial_hash_find_pairs_with(hash, scene->static_phase);
+}
+
+/**
+ * Returns whether a force creator should be invoked this tick.
+ * Collision force creators are skipped unless the broad phase found their
+ * bodies overlapping this tick or the last tick.
+ */
+bool force_should_run(scene_t *scene, force_t *force) {
+    if (force->removed) {
+        return false;
+    }
+    if (!force->is_collision) {
+        return true;
+    }
+    bool candidate = spatial_hash_has_pair(scene->broad_phase,
+        list_get(force->bodies, 0), list_get(force->bodies, 1));
+    bool was_candidate = force->candidate_last_tick;
+    force->candidate_last_tick = candidate;
+    return candidate || was_candidate;
+}
+
+/**
+ * Ticks every dynamic body, after adding back any bodies woken by this tick's
+ * forces. Bodies that become static or fall asleep are dropped from the
+ * dynamic set, as are removed bodies, which are freed afterwards.
+ */
+typedef struct {
+    list_t *bodies;
+    size_t shares;
+    double dt;
+} body_tick_task_t;
+
+/**
+ * Ticks a pool thread's contiguous share of the dynamic bodies.
+ */
+void run_body_ticks(size_t share, void *aux) {
+    body_tick_task_t *task = aux;
+    size_t size = list_size(task->bodies);
+    body_tick_list(task->bodies, share * size / task->shares,
+                   (share + 1) * size / task->shares, task->dt);
+}
+
+void scene_tick_dynamic_bodies(scene_t *scene, double dt) {
+    list_t *dynamic = scene->dynamic_bodies;
+    list_t *woken = scene->woken_bodies;
+    while (list_size(woken) > 0) {
+        body_t *body = list_remove_back(woken);
+        // The body may move away from where the static grid has it
+        if (has_collisions(body)) {
+            scene->static_phase_stale = true;
+        }
+        list_add(dynamic, body);
+    }
+
+    // Every body is integrated independently, so large scenes split the work
+    if (scene->pool != NULL && list_size(dynamic) >= SCENE_MIN_PARALLEL_BODIES) {
+        body_tick_task_t task = {dynamic, thread_pool_size(scene->pool), dt};
+        thread_pool_run(scene->pool, task.shares, run_body_ticks, &task);
+    }
+    else {
+        body_tick_list(dynamic, 0, list_size(dynamic), dt);
+    }
+
+    // Classifying may move bodies to the woken list, so it stays serial
+    size_t kept = 0;
+    for (size_t i = 0; i < list_size(dynamic); i++) {
+        body_t *body = list_get(dynamic, i);
+        if (body_is_removed(body)) {
+            continue;
+        }
+        body_motion_t motion = body_classify(body);
+        if (motion == BODY_DYNAMIC) {
+            list_set(dynamic, kept++, body);
+        }
+        else {
+            body_deactivate(body, motion, woken);
+            if (has_collisions(body)) {
+                scene->static_phase_stale = true;
+            }
+        }
+    }
+    while (list_size(dynamic) > kept) {
+        list_remove_back(dynamic);
+    }
+}
+
+/**
+ * Returns whether a force was removed or acts on a removed body.
+ * Keeps the scene's count of collision forces up to date for dead forces.
+ * Used with list_remove_if().
+ */
+bool force_is_dead(void *item, void *aux) {
+    force_t *force = item;
+    scene_t *scene = aux;
+    if (force->removed && force->is_collision) {
+        scene->num_collisions--;
+    }
+    return force->removed;
+}
+
+/**
+ * Returns whether a body was removed. Used with list_remove_if().
+ */
+bool body_is_dead(void *body, void *aux) {
+    return body_is_removed(body);
+}
+
+/**
+ * Frees every removed body and every force that was removed or acts on
+ * a removed body. Each list is compacted in a single pass, so removing
+ * k of n bodies costs O(n + k) rather than one array shift per body.
+ * The forces on a removed body are found through its own force list,
+ * so no force needs to check its bodies.
+ * Removed bodies have already left the dynamic set in
+ * scene_tick_dynamic_bodies().
+ */
+void scene_sweep_removed(scene_t *scene) {
+    // Find which tags have removed bodies, so only their lists are compacted
+    bool removed_tags[UCHAR_MAX + 1] = {false};
+    size_t num_removed = 0;
+    for (size_t i = 0; i < scene->size; i++) {
+        body_t *body = list_get(scene->bodies, i);
+        if (body_is_removed(body)) {
+            if (body_get_motion(body) != BODY_DYNAMIC && has_collisions(body)) {
+                scene->static_phase_stale = true;
             }
+            removed_tags[(unsigned char) body_get_tag(body)] = true;
+            unindex_body_forces(scene, body);
+            num_removed++;
+        }
+    }
+
+    if (num_removed > 0 || scene->forces_removed) {
+        list_remove_if(scene->forces, force_is_dead, scene);
+        scene->forces_removed = false;
+    }
+    if (num_removed == 0) {
+        return;
+    }
+    for (size_t tag = 0; tag <= UCHAR_MAX; tag++) {
+        if (removed_tags[tag] && tag != (unsigned char) BODY_NO_TAG) {
+            list_remove_if(scene->tagged_bodies[tag], body_is_dead, NULL);
+        }
+    }
+    scene->size -= list_remove_if(scene->bodies, body_is_dead, NULL);
+}
+
+/**
+ * Gets the first force creator in a pool thread's contiguous share
+ * of scene->parallel_forces.
+ */
+size_t parallel_share_start(scene_t *scene, size_t share) {
+    return share * scene->num_parallel_forces / thread_pool_size(scene->pool);
+}
+
+/**
+ * Runs a share of the pure force creators on a pool thread,
+ * capturing their forces in the share's own buffer.
+ */
+void run_parallel_forces(size_t share, void *aux) {
+    scene_t *scene = aux;
+    size_t end = parallel_share_start(scene, share + 1);
+    body_force_buffer_capture(scene->force_buffers[share]);
+    for (size_t i = parallel_share_start(scene, share); i < end; i++) {
+        force_t *force = scene->parallel_forces[i];
+        force->forcer(force->aux);
+    }
+    body_force_buffer_capture(NULL);
+}
+
+/**
+ * Runs a share of the collision detectors on a pool thread.
+ */
+void run_parallel_detectors(size_t share, void *aux) {
+    scene_t *scene = aux;
+    size_t end = parallel_share_start(scene, share + 1);
+    for (size_t i = parallel_share_start(scene, share); i < end; i++) {
+        force_t *force = scene->parallel_forces[i];
+        force->detector(force->aux);
+    }
+}
+
+void add_parallel_force(scene_t *scene, force_t *force) {
+    if (scene->num_parallel_forces == scene->parallel_forces_capacity) {
+        scene->parallel_forces_capacity = scene->parallel_forces_capacity == 0
+            ? SCENE_MIN_PARALLEL_FORCES : 2 * scene->parallel_forces_capacity;
+        scene->parallel_forces = realloc(scene->parallel_forces,
+            scene->parallel_forces_capacity * sizeof(force_t *));
+        assert(scene->parallel_forces != NULL && "Could not grow the parallel force list.");
+    }
+    scene->parallel_forces[scene->num_parallel_forces++] = force;
+}
+
+/**
+ * Runs the pure force creators across the thread pool,
+ * if there are enough of them to be worth it.
+ * The buffers are applied in share order, so each body receives its forces
+ * in the same order as if the pure force creators had run serially.
+ *
+ * @return whether the pure force creators were run
+ */
+bool scene_run_pure_forces(scene_t *scene, size_t num_forces) {
+    list_t *forces = scene->forces;
+    scene->num_parallel_forces = 0;
+    for (size_t i = 0; i < num_forces; i++) {
+        force_t *force = list_get(forces, i);
+        if (force->is_pure && force->runs_this_tick) {
+            add_parallel_force(scene, force);
+        }
+    }
+    if (scene->num_parallel_forces < SCENE_MIN_PARALLEL_FORCES) {
+        return false;
+    }
+    size_t shares = thread_pool_size(scene->pool);
+    thread_pool_run(scene->pool, shares, run_parallel_forces, scene);
+    for (size_t i = 0; i < shares; i++) {
+        body_force_buffer_apply(scene->force_buffers[i]);
+    }
+    return true;
+}
+
+/**
+ * Runs the collision detectors across the thread pool,
+ * if there are enough of them to be worth it.
+ * Each body's world vertices and bounding box are computed first,
+ * since the bodies compute them lazily and detectors may only read.
+ *
+ * @return whether the collision detectors were run
+ */
+bool scene_run_detectors(scene_t *scene, size_t num_forces) {
+    list_t *forces = scene->forces;
+    scene->num_parallel_forces = 0;
+    for (size_t i = 0; i < num_forces; i++) {
+        force_t *force = list_get(forces, i);
+        if (force->detector != NULL && force->runs_this_tick) {
+            add_parallel_force(scene, force);
+        }
+    }
+    if (scene->num_parallel_forces < SCENE_MIN_PARALLEL_FORCES) {
+        return false;
+    }
+    for (size_t i = 0; i < scene->num_parallel_forces; i++) {
+        list_t *bodies = scene->parallel_forces[i]->bodies;
+        for (size_t j = 0; j < list_size(bodies); j++) {
+            body_get_shape_view(list_get(bodies, j));
+            body_get_bounding_box(list_get(bodies, j));
+        }
+    }
+    thread_pool_run(scene->pool, thread_pool_size(scene->pool), run_parallel_detectors, scene);
+    return true;
+}
+
+/**
+ * Runs every force creator for a tick.
+ * On a single thread, each one runs in the order it was added, right after
+ * its detector. With a thread pool, the pure force creators and then the
+ * collision detectors are run in parallel, and everything else runs
+ * serially in the order it was added.
+ * Force creators added by others during the tick run at the end of it.
+ */
+void scene_run_forces(scene_t *scene) {
+    list_t *forces = scene->forces;
+    // force_should_run() tracks the broad phase across ticks,
+    // so it must be called exactly once per force creator
+    size_t num_forces = list_size(forces);
+    for (size_t i = 0; i < num_forces; i++) {
+        force_t *force = list_get(forces, i);
+        force->runs_this_tick = force_should_run(scene, force);
+    }
+
+    bool pure_done = false, detected = false;
+    if (scene->pool != NULL) {
+        pure_done = scene_run_pure_forces(scene, num_forces);
+        detected = scene_run_detectors(scene, num_forces);
+    }
+
+    for (size_t i = 0; i < list_size(forces); i++) {
+        force_t *force = list_get(forces, i);
+        bool runs = i < num_forces ? force->runs_this_tick : force_should_run(scene, force);
+        // An earlier collision handler may have removed this force
+        if (!runs || force->removed || (pure_done && force->is_pure)) {
+            continue;
+        }
+        if (force->detector != NULL && !(detected && i < num_forces)) {
+            force->detector(force->aux);
+        }
+        force->forcer(force->aux);
+    }
+}
+
+void scene_tick(scene_t *scene, double dt) {
+    scene->query_index_stale = true;
+    if (! scene->pause) { 
+        if (scene->num_collisions > 0) {
+            scene_update_broad_phase(scene);
         }
+
+        scene_run_forces(scene);
+
+        scene_tick_dynamic_bodies(scene, dt);
+        scene_sweep_removed(scene);
     }
     else {
-        for(size_t i = 0; i < scene->size; i++) {
-            body_t *current_body = list_get(scene->bodies, i);
-            if (((char *) body_get_info(current_body))[0] == 'C' || ((char *) body_get_info(current_body))[0] == 'I') {
-                body_tick(current_body, dt);
+        // Only the cursor keeps moving while the scene is paused
+        const char PAUSED_TAGS[] = {'C', 'I'};
+        for (size_t i = 0; i < sizeof(PAUSED_TAGS); i++) {
+            list_t *cursor = scene_get_tagged_bodies(scene, PAUSED_TAGS[i]);
+            for (size_t j = 0; j < list_size(cursor); j++) {
+                body_tick(list_get(cursor, j), dt);
             }
         }
     }   
 }
+
+body_t *scene_raycast(
+    scene_t *scene,
+    vector_t origin,
+    vector_t direction,
+    double max_length,
+    raycast_filter_t filter,
+    void *aux,
+    ray_hit_t *hit
+){
+    double length = sqrt(vec_dot(direction, direction));
+    assert(length > 0 && "Cannot cast a ray without a direction.");
+    direction = vec_multiply(1 / length, direction);
+    if (scene->query_index_stale) {
+        spatial_hash_clear(scene->query_index);
+        for (size_t i = 0; i < scene->size; i++) {
+            body_t *body = list_get(scene->bodies, i);
+            spatial_hash_insert(scene->query_index, body, body_get_bounding_box(body));
+        }
+        scene->query_index_stale = false;
+    }
+
+    list_t *candidates = scene->query_candidates;
+    while (list_size(candidates) > 0) {
+        list_remove_back(candidates);
+    }
+    vector_t end = vec_add(origin, vec_multiply(max_length, direction));
+    spatial_hash_query_segment(scene->query_index, origin, end, candidates);
+
+    body_t *closest = NULL;
+    ray_hit_t closest_hit = {false, max_length, VEC_ZERO, VEC_ZERO};
+    for (size_t i = 0; i < list_size(candidates); i++) {
+        body_t *body = list_get(candidates, i);
+        if (body_is_removed(body) || (filter != NULL && !filter(body, aux))) {
+            continue;
+        }
+        // Only hits nearer than the closest so far matter
+        ray_hit_t body_hit = find_ray_body_hit(origin, direction, closest_hit.distance, body);
+        if (body_hit.hit && (closest == NULL || body_hit.distance < closest_hit.distance)) {
+            closest = body;
+            closest_hit = body_hit;
+        }
+    }
+    if (hit != NULL) {
+        *hit = closest_hit;
+    }
+    return closest;
+}
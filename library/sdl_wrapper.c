@@ -1,7 +1,6 @@
 #include <assert.h>
 #include <math.h>
 #include <stdlib.h>
-#include <time.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL2_gfxPrimitives.h>
 #include <SDL2/SDL_ttf.h>
@@ -13,6 +12,29 @@ const char WINDOW_TITLE[] = "CS 3";
 const int WINDOW_WIDTH = 1000;
 const int WINDOW_HEIGHT = 500;
 const double MS_PER_S = 1e3;
+// Polygons up to this size are converted to screen coordinates on the stack
+#define DRAW_STACK_VERTICES 64
+// Circles are drawn as fans of this many triangles
+#define CIRCLE_SEGMENTS 32
+
+// SDL_RenderGeometry() lets shapes and images share batched draw calls
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+#define SDL_WRAPPER_HAS_GEOMETRY
+#endif
+
+/**
+ * Triangles that share a texture, or have none, waiting to be drawn
+ * together by one SDL_RenderGeometry() call.
+ */
+typedef struct {
+    SDL_Texture *texture;
+    SDL_Vertex *vertices;
+    size_t num_vertices;
+    size_t vertex_capacity;
+    int *indices;
+    size_t num_indices;
+    size_t index_capacity;
+} geometry_batch_t;
 
 /**
  * The coordinate at the center of the screen.
@@ -40,10 +62,24 @@ key_handler_t key_handler = NULL;
  */
 uint32_t key_start_timestamp;
 /**
- * The value of clock() when time_since_last_tick() was last called.
- * Initially 0.
+ * Times the frames marked by time_since_last_tick().
+ * Created the first time it is needed.
  */
-clock_t last_clock = 0;
+frame_timer_t *frame_timer = NULL;
+/**
+ * How far between their last two states bodies are drawn.
+ * See sdl_set_interpolation().
+ */
+double interpolation_alpha = 1.0;
+/**
+ * The triangles drawn since the last flush. See batch_flush().
+ */
+geometry_batch_t batch = {NULL, NULL, 0, 0, NULL, 0, 0};
+/**
+ * The number of draw calls made for the current frame and the last shown one.
+ */
+size_t frame_draw_calls = 0;
+size_t last_frame_draw_calls = 0;
 
 /** Computes the center of the window in pixel coordinates */
 vector_t get_window_center(void) {
@@ -139,8 +175,6 @@ bool sdl_is_done(void *data) {
     while (SDL_PollEvent(event)) {
         switch (event->type) {
             case SDL_QUIT:
-                TTF_Quit();
-                IMG_Quit();
                 free(event);
                 return true;
             case SDL_KEYDOWN:
@@ -181,29 +215,151 @@ bool sdl_is_done(void *data) {
     return false;
 }
 
+/**
+ * Draws every triangle in the batch and empties it.
+ * Must be called before drawing anything without the batch,
+ * so that it is layered correctly.
+ */
+void batch_flush(void) {
+#ifdef SDL_WRAPPER_HAS_GEOMETRY
+    if (batch.num_indices > 0) {
+        SDL_RenderGeometry(renderer, batch.texture, batch.vertices, batch.num_vertices,
+                           batch.indices, batch.num_indices);
+        frame_draw_calls++;
+    }
+#endif
+    batch.num_vertices = 0;
+    batch.num_indices = 0;
+}
+
+/**
+ * Makes room in the batch for new triangles with the given texture,
+ * flushing the batch first if its triangles use another texture.
+ *
+ * @param texture the texture of the triangles, or NULL for solid colors
+ * @param num_vertices the number of vertices to be added
+ * @param num_indices the number of indices to be added
+ * @return the index of the first vertex to be added
+ */
+size_t batch_reserve(SDL_Texture *texture, size_t num_vertices, size_t num_indices) {
+    if (texture != batch.texture) {
+        batch_flush();
+        batch.texture = texture;
+    }
+    if (batch.num_vertices + num_vertices > batch.vertex_capacity) {
+        batch.vertex_capacity = 2 * (batch.num_vertices + num_vertices);
+        batch.vertices = realloc(batch.vertices, sizeof(SDL_Vertex) * batch.vertex_capacity);
+        assert(batch.vertices != NULL);
+    }
+    if (batch.num_indices + num_indices > batch.index_capacity) {
+        batch.index_capacity = 2 * (batch.num_indices + num_indices);
+        batch.indices = realloc(batch.indices, sizeof(int) * batch.index_capacity);
+        assert(batch.indices != NULL);
+    }
+    return batch.num_vertices;
+}
+
+void batch_add_vertex(vector_t pixel, SDL_Color color, double u, double v) {
+    batch.vertices[batch.num_vertices++] = (SDL_Vertex) {
+        {pixel.x, pixel.y}, color, {u, v}
+    };
+}
+
+void batch_add_triangle(size_t a, size_t b, size_t c) {
+    batch.indices[batch.num_indices++] = a;
+    batch.indices[batch.num_indices++] = b;
+    batch.indices[batch.num_indices++] = c;
+}
+
+/**
+ * Converts a color with components from 0 to 1 to an opaque SDL color.
+ */
+SDL_Color get_sdl_color(rgb_color_t color) {
+    assert(0 <= color.r && color.r <= 1);
+    assert(0 <= color.g && color.g <= 1);
+    assert(0 <= color.b && color.b <= 1);
+    return (SDL_Color) {color.r * 255, color.g * 255, color.b * 255, 255};
+}
+
+/**
+ * Draws a texture stretched over a rectangle, turned about its center.
+ *
+ * @param texture the texture to draw
+ * @param bounds the rectangle in pixels, before it is turned
+ * @param angle the angle to turn the rectangle clockwise, in degrees
+ */
+void draw_texture(SDL_Texture *texture, SDL_Rect bounds, double angle) {
+#ifdef SDL_WRAPPER_HAS_GEOMETRY
+    const SDL_Color white = {255, 255, 255, 255};
+    vector_t middle = {bounds.x + bounds.w / 2.0, bounds.y + bounds.h / 2.0};
+    double radians = angle * M_PI / 180;
+    // y points down on screen, so this turns the corners clockwise
+    vector_t across = vec_rotate((vector_t) {bounds.w / 2.0, 0}, radians);
+    vector_t down = vec_rotate((vector_t) {0, bounds.h / 2.0}, radians);
+    size_t first = batch_reserve(texture, 4, 6);
+    batch_add_vertex(vec_subtract(vec_subtract(middle, across), down), white, 0, 0);
+    batch_add_vertex(vec_subtract(vec_add(middle, across), down), white, 1, 0);
+    batch_add_vertex(vec_add(vec_add(middle, across), down), white, 1, 1);
+    batch_add_vertex(vec_add(vec_subtract(middle, across), down), white, 0, 1);
+    batch_add_triangle(first, first + 1, first + 2);
+    batch_add_triangle(first, first + 2, first + 3);
+#else
+    SDL_RenderCopyEx(renderer, texture, NULL, &bounds, angle, NULL, SDL_FLIP_NONE);
+    frame_draw_calls++;
+#endif
+}
+
 void sdl_clear(void) {
+    batch_flush();
     SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
     SDL_RenderClear(renderer);
 }
 
 void sdl_draw_polygon(list_t *points, rgb_color_t color) {
-    // Check parameters
     size_t n = list_size(points);
+    vector_t *vertices = malloc(sizeof(*vertices) * n);
+    assert(vertices != NULL);
+    for (size_t i = 0; i < n; i++) {
+        vertices[i] = *(vector_t *) list_get(points, i);
+    }
+    sdl_draw_polygon_view((polygon_view_t) {vertices, n}, color);
+    free(vertices);
+}
+
+void sdl_draw_polygon_view(polygon_view_t shape, rgb_color_t color) {
+    // Check parameters
+    size_t n = shape.size;
     assert(n >= 3);
-    assert(0 <= color.r && color.r <= 1);
-    assert(0 <= color.g && color.g <= 1);
-    assert(0 <= color.b && color.b <= 1);
+    SDL_Color sdl_color = get_sdl_color(color);
 
     vector_t window_center = get_window_center();
 
-    // Convert each vertex to a point on screen
-    int16_t *x_points = malloc(sizeof(*x_points) * n),
-            *y_points = malloc(sizeof(*y_points) * n);
-    assert(x_points != NULL);
-    assert(y_points != NULL);
+#ifdef SDL_WRAPPER_HAS_GEOMETRY
+    // Fan the triangles out from the mean of the vertices,
+    // which lies inside any convex or star-shaped polygon
+    size_t first = batch_reserve(NULL, n + 1, 3 * n);
+    vector_t mean = VEC_ZERO;
+    for (size_t i = 0; i < n; i++) {
+        vector_t pixel = get_window_position(shape.points[i], window_center);
+        batch_add_vertex(pixel, sdl_color, 0, 0);
+        mean = vec_add(mean, pixel);
+    }
+    batch_add_vertex(vec_multiply(1.0 / n, mean), sdl_color, 0, 0);
+    for (size_t i = 0; i < n; i++) {
+        batch_add_triangle(first + n, first + i, first + (i + 1) % n);
+    }
+#else
+    // Convert each vertex to a point on screen, using the stack for small polygons
+    int16_t x_buffer[DRAW_STACK_VERTICES], y_buffer[DRAW_STACK_VERTICES];
+    int16_t *x_points = x_buffer, *y_points = y_buffer;
+    if (n > DRAW_STACK_VERTICES) {
+        x_points = malloc(sizeof(*x_points) * n);
+        y_points = malloc(sizeof(*y_points) * n);
+        assert(x_points != NULL);
+        assert(y_points != NULL);
+    }
     for (size_t i = 0; i < n; i++) {
-        vector_t *vertex = list_get(points, i);
-        vector_t pixel = get_window_position(*vertex, window_center);
+        vector_t pixel = get_window_position(shape.points[i], window_center);
         x_points[i] = pixel.x;
         y_points[i] = pixel.y;
     }
@@ -212,35 +368,137 @@ void sdl_draw_polygon(list_t *points, rgb_color_t color) {
     filledPolygonRGBA(
         renderer,
         x_points, y_points, n,
-        color.r * 255, color.g * 255, color.b * 255, 255
+        sdl_color.r, sdl_color.g, sdl_color.b, 255
     );
-    free(x_points);
-    free(y_points);
+    frame_draw_calls++;
+    if (x_points != x_buffer) {
+        free(x_points);
+        free(y_points);
+    }
+#endif
+}
+
+void sdl_draw_circle(vector_t center, double radius, rgb_color_t color) {
+    SDL_Color sdl_color = get_sdl_color(color);
+
+    vector_t window_center = get_window_center();
+    vector_t pixel = get_window_position(center, window_center);
+    double pixel_radius = round(radius * get_scene_scale(window_center));
+#ifdef SDL_WRAPPER_HAS_GEOMETRY
+    // The fan of a unit circle, computed the first time a circle is drawn
+    static vector_t unit_circle[CIRCLE_SEGMENTS];
+    static bool has_unit_circle = false;
+    if (!has_unit_circle) {
+        for (size_t i = 0; i < CIRCLE_SEGMENTS; i++) {
+            double angle = 2 * M_PI * i / CIRCLE_SEGMENTS;
+            unit_circle[i] = (vector_t) {cos(angle), sin(angle)};
+        }
+        has_unit_circle = true;
+    }
+    size_t first = batch_reserve(NULL, CIRCLE_SEGMENTS + 1, 3 * CIRCLE_SEGMENTS);
+    for (size_t i = 0; i < CIRCLE_SEGMENTS; i++) {
+        batch_add_vertex(vec_add(pixel, vec_multiply(pixel_radius, unit_circle[i])), sdl_color, 0, 0);
+    }
+    batch_add_vertex(pixel, sdl_color, 0, 0);
+    for (size_t i = 0; i < CIRCLE_SEGMENTS; i++) {
+        batch_add_triangle(first + CIRCLE_SEGMENTS, first + i, first + (i + 1) % CIRCLE_SEGMENTS);
+    }
+#else
+    filledCircleRGBA(
+        renderer,
+        pixel.x, pixel.y, pixel_radius,
+        sdl_color.r, sdl_color.g, sdl_color.b, 255
+    );
+    frame_draw_calls++;
+#endif
+}
+
+void sdl_set_interpolation(double alpha) {
+    assert(0 <= alpha && alpha <= 1);
+    interpolation_alpha = alpha;
+}
+
+void sdl_draw_body(body_t *body) {
+    if (body_is_circle(body)) {
+        vector_t center = body_get_interpolated_centroid(body, interpolation_alpha);
+        sdl_draw_circle(center, body_get_radius(body), body_get_color(body));
+        return;
+    }
+    vector_t buffer[DRAW_STACK_VERTICES];
+    vector_t *points = buffer;
+    size_t n = body_get_num_vertices(body);
+    if (n > DRAW_STACK_VERTICES) {
+        points = malloc(sizeof(*points) * n);
+        assert(points != NULL);
+    }
+    polygon_view_t shape = body_get_interpolated_shape(body, interpolation_alpha, points);
+    sdl_draw_polygon_view(shape, body_get_color(body));
+    if (points != buffer) {
+        free(points);
+    }
 }
 
 /**
  * Renders the image for a body, if there is one.
  */ 
 void render_body_image(body_t *body) {
-    if (body_has_image_list(body)) {
+    if (body_has_image(body)) {
         image_t *body_image = body_get_current_image(body);
-        vector_t centroid = body_get_centroid(body);
+        vector_t centroid = body_get_interpolated_centroid(body, interpolation_alpha);
         vector_t image_dimensions = image_get_dimensions(body_image);
 
-        SDL_Rect *image_bounds = malloc(sizeof(*image_bounds));
-        image_bounds->x = centroid.x - image_dimensions.x / 2;
-        image_bounds->y = 500 - image_dimensions.y / 2 - centroid.y;
-        image_bounds->w = image_dimensions.x;
-        image_bounds->h = image_dimensions.y;
+        SDL_Rect image_bounds;
+        image_bounds.x = centroid.x - image_dimensions.x / 2;
+        image_bounds.y = 500 - image_dimensions.y / 2 - centroid.y;
+        image_bounds.w = image_dimensions.x;
+        image_bounds.h = image_dimensions.y;
+
+        draw_texture(image_get_texture(body_image, renderer), image_bounds, image_get_rotation(body_image));
+    }
+}
+
+/**
+ * Renders every body with one of the given tags, looked up through the
+ * scene's tag index instead of scanning all of its bodies.
+ *
+ * @param scene the scene containing the bodies
+ * @param tags the tags to render, in order
+ * @param shapes true to draw the bodies' shapes, false to draw their images
+ */
+void render_tagged_bodies(scene_t *scene, const char *tags, bool shapes) {
+    for (size_t i = 0; tags[i] != '\0'; i++) {
+        list_t *bodies = scene_get_tagged_bodies(scene, tags[i]);
+        for (size_t j = 0; j < list_size(bodies); j++) {
+            if (shapes) {
+                sdl_draw_body(list_get(bodies, j));
+            }
+            else {
+                render_body_image(list_get(bodies, j));
+            }
+        }
+    }
+}
 
-        SDL_Texture *image_texture = SDL_CreateTextureFromSurface(renderer, image_get_surface(body_image));
-        SDL_RenderCopyEx(renderer, image_texture, NULL, image_bounds, image_get_rotation(body_image), NULL, SDL_FLIP_NONE);
-        SDL_DestroyTexture(image_texture);
-        free(image_bounds);
+/**
+ * Renders the shapes of every body in a scene except for the cursor.
+ *
+ * @param scene the scene containing the bodies
+ * @param with_images true to draw the bodies that have an image, false to draw the rest
+ */
+void render_scene_shapes(scene_t *scene, bool with_images) {
+    for (size_t i = 0; i < scene_bodies(scene); i++) {
+        body_t *body = scene_get_body(scene, i);
+        char tag = body_get_tag(body);
+        if (tag != 'C' && tag != 'I' && body_has_image(body) == with_images) {
+            sdl_draw_body(body);
+        }
     }
 }
 
 void sdl_show(scene_t *scene, list_t *textboxes) {
+    // Draw anything already batched under the boundary lines
+    batch_flush();
+
     // Draw boundary lines
     vector_t window_center = get_window_center();
     vector_t max = vec_add(center, max_diff),
@@ -254,55 +512,41 @@ void sdl_show(scene_t *scene, list_t *textboxes) {
     boundary->h = min_pixel.y - max_pixel.y;
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderDrawRect(renderer, boundary);
+    frame_draw_calls++;
 
-    // Render the background image under everything. Potential optimization: this doesn't have to be done over and over again
+    // Render the background image under everything
     if (scene_has_background(scene)) {
-        SDL_Texture *background_texture = SDL_CreateTextureFromSurface(renderer, image_get_surface(scene_get_background(scene)));
-        assert(background_texture != NULL && "Scene background texture is null!");
-        SDL_RenderCopyEx(renderer, background_texture, NULL, boundary, 0, NULL, SDL_FLIP_NONE);
-        SDL_DestroyTexture(background_texture);
+        draw_texture(image_get_texture(scene_get_background(scene), renderer), *boundary, 0);
     }
     
-    // Render all bodies and their images on top of them except for the cursor and the player image
+    // Render all bodies except for the cursor, with their images on top of them except for the player image.
+    // The shapes under images share one batch and images of the same file share another.
+    // Shapes without an image are drawn last so that they stay above the images, as when every
+    // body drew its shape and then its image.
+    render_scene_shapes(scene, true);
     for (size_t i = 0; i < scene_bodies(scene); i++) {
         body_t *body = scene_get_body(scene, i);
-        char body_info = ((char *) body_get_info(body))[0];
-
-        if (body_info != 'C' && body_info != 'I') {
-            // body_get_shape returns a copy of shape, so we can free this copy
-            list_t *shape = body_get_shape(body);
-            sdl_draw_polygon(shape, body_get_color(body));
-            list_free(shape);
-            
-            if (body_info != 'P' && body_info != 'E') {
-                render_body_image(body);
-            }
+        char tag = body_get_tag(body);
+        if (tag != 'C' && tag != 'I' && tag != 'P' && tag != 'E') {
+            render_body_image(body);
         }
     }
+    render_scene_shapes(scene, false);
 
     // Render the target image and player image on top of everything except for cursor and text_image popup
-    for (size_t i = 0; i < scene_bodies(scene); i++) {
-        body_t *body = scene_get_body(scene, i);
-        char *body_info = (char *) body_get_info(body);
-
-        if (((char *) body_info)[0] == 'P' || ((char *) body_info)[0] == 'E') {
-            render_body_image(body);
-        }
-    }
+    render_tagged_bodies(scene, "PE", false);
 
     // Render all text image popups
     list_t *text_images = scene_get_text_images(scene);
     for (size_t i = 0; i < list_size(text_images); i++) {
         if (scene_show_text_image(scene, i)) {
-            SDL_Texture *text_image_texture = SDL_CreateTextureFromSurface(renderer, image_get_surface(list_get(text_images, i)));
-            assert(text_image_texture != NULL && "Scene text_image texture is null!");
-            vector_t dimensions = image_get_dimensions(list_get(text_images, i));
+            image_t *text_image = list_get(text_images, i);
+            vector_t dimensions = image_get_dimensions(text_image);
             boundary->x = (min_pixel.x + max_pixel.x - dimensions.x) / 2;
             boundary->y = (max_pixel.y + min_pixel.y - dimensions.y) / 2;
             boundary->w = dimensions.x;
             boundary->h = dimensions.y;
-            SDL_RenderCopyEx(renderer, text_image_texture, NULL, boundary, 0, NULL, SDL_FLIP_NONE);
-            SDL_DestroyTexture(text_image_texture);
+            draw_texture(image_get_texture(text_image, renderer), *boundary, 0);
         }
     }
     
@@ -310,18 +554,12 @@ void sdl_show(scene_t *scene, list_t *textboxes) {
     sdl_render_text(scene, textboxes);
 
     // Render the cursor last to make it on top of everything
-    for (size_t i = 0; i < scene_bodies(scene); i++) {
-        body_t *body = scene_get_body(scene, i);
-        char *body_info = (char *) body_get_info(body);
-        if (((char *) body_info)[0] == 'C' || ((char *) body_info)[0] == 'I') {
-            // body_get_shape returns a copy of shape, so we can free this copy
-            list_t *shape = body_get_shape(body);
-            sdl_draw_polygon(shape, body_get_color(body));
-            list_free(shape);
-        }
-    }
+    render_tagged_bodies(scene, "CI", true);
 
+    batch_flush();
     SDL_RenderPresent(renderer);
+    last_frame_draw_calls = frame_draw_calls;
+    frame_draw_calls = 0;
     free(boundary);
 }
 
@@ -333,17 +571,13 @@ void sdl_render_scene(scene_t *scene, list_t *textboxes) {
 void sdl_render_text(scene_t *scene, list_t *textboxes){
     for(size_t i = 0; i < list_size(textboxes); i++) {
         textbox_t *tb= (textbox_t *) list_get(textboxes, i);
-        SDL_Surface* surfaceMessage = TTF_RenderText_Solid(textbox_get_font(tb), textbox_get_text(tb),
-                                                                     textbox_get_color(tb)); 
-        SDL_Texture* Message = SDL_CreateTextureFromSurface(renderer, surfaceMessage);
         SDL_Rect rect; //create a rect
         rect.x = textbox_get_x(tb);  //controls the rect's x coordinate 
         rect.y = textbox_get_y(tb);  // controls the rect's y coordinte
         rect.w = textbox_get_width(tb);  // controls the width of the rect
         rect.h = textbox_get_height(tb);  // controls the height of the rect
-        SDL_RenderCopy(renderer, Message, NULL, &rect);
-        SDL_FreeSurface(surfaceMessage);
-        SDL_DestroyTexture(Message);
+        // The text is only rendered again when it changes
+        draw_texture(textbox_get_texture(tb, renderer), rect, 0);
     }
 }
 
@@ -351,16 +585,33 @@ void sdl_on_key(key_handler_t handler) {
     key_handler = handler;
 }
 
+frame_timer_t *sdl_get_frame_timer(void) {
+    if (frame_timer == NULL) {
+        frame_timer = frame_timer_init();
+    }
+    return frame_timer;
+}
+
 double time_since_last_tick(void) {
-    clock_t now = clock();
-    double difference = last_clock
-        ? (double) (now - last_clock) / CLOCKS_PER_SEC
-        : 0.0; // return 0 the first time this is called
-    last_clock = now;
-    return difference;
+    // Wall time, unlike clock(), keeps counting while waiting on the display
+    return frame_timer_tick(sdl_get_frame_timer());
+}
+
+size_t sdl_get_draw_calls(void) {
+    return last_frame_draw_calls;
 }
 
 void sdl_free() {
+    // Destroying the renderer destroys every texture cached by images and textboxes
+    image_invalidate_textures();
+    textbox_invalidate_textures();
+    // Triangles left in the batch may use textures of the old renderer
+    batch.num_vertices = 0;
+    batch.num_indices = 0;
+    batch.texture = NULL;
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
+    // Every font and image must already be freed, since sdl_init() starts these again
+    TTF_Quit();
+    IMG_Quit();
 }
@@ -0,0 +1,478 @@
+#include "spatial_hash.h"
+#include "polygon.h"
+#include "list.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Boxes covering more cells than this are compared against every value instead
+const size_t SPATIAL_HASH_MAX_CELLS_PER_ITEM = 64;
+const size_t SPATIAL_HASH_INITIAL_CAPACITY = 16;
+
+typedef struct {
+    void *value;
+    bounding_box_t box;
+    size_t stamp;
+} hash_item_t;
+
+typedef struct {
+    long x;
+    long y;
+    size_t item;
+} cell_entry_t;
+
+typedef struct {
+    void *first;
+    void *second;
+} hash_pair_t;
+
+typedef struct spatial_hash {
+    double cell_size;
+    hash_item_t *items;
+    size_t num_items;
+    size_t item_capacity;
+    cell_entry_t *cells;
+    size_t num_cells;
+    size_t cell_capacity;
+    size_t *large_items;
+    size_t num_large;
+    size_t large_capacity;
+    bool sorted;
+    hash_pair_t *pairs;
+    size_t num_pairs;
+    size_t pair_capacity;
+    size_t stamp;
+} spatial_hash_t;
+
+/**
+ * Grows a dynamic array so that it can hold at least needed elements.
+ */
+static void *ensure_capacity(void *array, size_t *capacity, size_t needed, size_t elem_size) {
+    if (needed <= *capacity) {
+        return array;
+    }
+    size_t new_capacity = *capacity == 0 ? SPATIAL_HASH_INITIAL_CAPACITY : *capacity;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+    array = realloc(array, new_capacity * elem_size);
+    assert(array != NULL && "Could not grow spatial hash storage.");
+    *capacity = new_capacity;
+    return array;
+}
+
+spatial_hash_t *spatial_hash_init(double cell_size) {
+    assert(cell_size > 0);
+    spatial_hash_t *hash = malloc(sizeof(spatial_hash_t));
+    assert(hash != NULL && "Could not allocate memory for a new spatial_hash_t.");
+    hash->cell_size = cell_size;
+    hash->items = NULL;
+    hash->num_items = 0;
+    hash->item_capacity = 0;
+    hash->cells = NULL;
+    hash->num_cells = 0;
+    hash->cell_capacity = 0;
+    hash->large_items = NULL;
+    hash->num_large = 0;
+    hash->large_capacity = 0;
+    hash->sorted = true;
+    hash->pairs = NULL;
+    hash->num_pairs = 0;
+    hash->pair_capacity = 0;
+    hash->stamp = 0;
+    return hash;
+}
+
+void spatial_hash_free(spatial_hash_t *hash) {
+    free(hash->items);
+    free(hash->cells);
+    free(hash->large_items);
+    free(hash->pairs);
+    free(hash);
+}
+
+void spatial_hash_clear(spatial_hash_t *hash) {
+    hash->num_items = 0;
+    hash->num_cells = 0;
+    hash->num_large = 0;
+    hash->num_pairs = 0;
+    hash->sorted = true;
+    if (hash->pairs != NULL) {
+        memset(hash->pairs, 0, hash->pair_capacity * sizeof(hash_pair_t));
+    }
+}
+
+size_t spatial_hash_size(spatial_hash_t *hash) {
+    return hash->num_items;
+}
+
+static long cell_coord(spatial_hash_t *hash, double coord) {
+    return (long) floor(coord / hash->cell_size);
+}
+
+void spatial_hash_insert(spatial_hash_t *hash, void *value, bounding_box_t box) {
+    assert(value != NULL);
+    hash->items = ensure_capacity(hash->items, &hash->item_capacity,
+                                  hash->num_items + 1, sizeof(hash_item_t));
+    size_t index = hash->num_items++;
+    hash->items[index] = (hash_item_t) {value, box, 0};
+
+    long min_x = cell_coord(hash, box.min.x), max_x = cell_coord(hash, box.max.x);
+    long min_y = cell_coord(hash, box.min.y), max_y = cell_coord(hash, box.max.y);
+    double covered = ((double) (max_x - min_x) + 1) * ((double) (max_y - min_y) + 1);
+    if (covered > SPATIAL_HASH_MAX_CELLS_PER_ITEM) {
+        hash->large_items = ensure_capacity(hash->large_items, &hash->large_capacity,
+                                            hash->num_large + 1, sizeof(size_t));
+        hash->large_items[hash->num_large++] = index;
+        return;
+    }
+
+    hash->cells = ensure_capacity(hash->cells, &hash->cell_capacity,
+                                  hash->num_cells + (size_t) covered, sizeof(cell_entry_t));
+    for (long x = min_x; x <= max_x; x++) {
+        for (long y = min_y; y <= max_y; y++) {
+            hash->cells[hash->num_cells++] = (cell_entry_t) {x, y, index};
+        }
+    }
+    hash->sorted = false;
+}
+
+static int compare_cells(const void *a, const void *b) {
+    const cell_entry_t *cell1 = a, *cell2 = b;
+    if (cell1->x != cell2->x) {
+        return cell1->x < cell2->x ? -1 : 1;
+    }
+    if (cell1->y != cell2->y) {
+        return cell1->y < cell2->y ? -1 : 1;
+    }
+    return (cell1->item > cell2->item) - (cell1->item < cell2->item);
+}
+
+static void sort_cells(spatial_hash_t *hash) {
+    if (!hash->sorted) {
+        qsort(hash->cells, hash->num_cells, sizeof(cell_entry_t), compare_cells);
+        hash->sorted = true;
+    }
+}
+
+static hash_pair_t make_pair(void *value1, void *value2) {
+    if ((uintptr_t) value1 < (uintptr_t) value2) {
+        return (hash_pair_t) {value1, value2};
+    }
+    return (hash_pair_t) {value2, value1};
+}
+
+static size_t pair_slot(hash_pair_t pair, size_t capacity) {
+    uint64_t key = (uint64_t) (uintptr_t) pair.first * 0x9E3779B97F4A7C15ULL;
+    key ^= (uint64_t) (uintptr_t) pair.second + 0x7F4A7C159E3779B9ULL + (key << 6) + (key >> 2);
+    key ^= key >> 29;
+    return (size_t) key & (capacity - 1);
+}
+
+static bool insert_pair_into(hash_pair_t *pairs, size_t capacity, hash_pair_t pair) {
+    size_t slot = pair_slot(pair, capacity);
+    while (pairs[slot].first != NULL) {
+        if (pairs[slot].first == pair.first && pairs[slot].second == pair.second) {
+            return false;
+        }
+        slot = (slot + 1) & (capacity - 1);
+    }
+    pairs[slot] = pair;
+    return true;
+}
+
+static void add_pair(spatial_hash_t *hash, void *value1, void *value2) {
+    // Keep the open-addressed table at most half full
+    if (2 * (hash->num_pairs + 1) > hash->pair_capacity) {
+        size_t new_capacity = hash->pair_capacity == 0
+            ? SPATIAL_HASH_INITIAL_CAPACITY * 4 : hash->pair_capacity * 2;
+        hash_pair_t *new_pairs = calloc(new_capacity, sizeof(hash_pair_t));
+        assert(new_pairs != NULL && "Could not grow spatial hash pair table.");
+        for (size_t i = 0; i < hash->pair_capacity; i++) {
+            if (hash->pairs[i].first != NULL) {
+                insert_pair_into(new_pairs, new_capacity, hash->pairs[i]);
+            }
+        }
+        free(hash->pairs);
+        hash->pairs = new_pairs;
+        hash->pair_capacity = new_capacity;
+    }
+    if (insert_pair_into(hash->pairs, hash->pair_capacity, make_pair(value1, value2))) {
+        hash->num_pairs++;
+    }
+}
+
+static void try_pair(spatial_hash_t *hash, size_t item1, size_t item2) {
+    hash_item_t *a = &hash->items[item1], *b = &hash->items[item2];
+    if (a->value != b->value && bounding_box_overlap(a->box, b->box)) {
+        add_pair(hash, a->value, b->value);
+    }
+}
+
+size_t spatial_hash_find_pairs(spatial_hash_t *hash) {
+    sort_cells(hash);
+
+    // Compare every two values sharing a cell; runs of equal cells are adjacent
+    size_t start = 0;
+    while (start < hash->num_cells) {
+        size_t end = start + 1;
+        while (end < hash->num_cells && hash->cells[end].x == hash->cells[start].x
+               && hash->cells[end].y == hash->cells[start].y) {
+            end++;
+        }
+        for (size_t i = start; i < end; i++) {
+            for (size_t j = i + 1; j < end; j++) {
+                try_pair(hash, hash->cells[i].item, hash->cells[j].item);
+            }
+        }
+        start = end;
+    }
+
+    // Oversized values skip the grid, so compare them against everything
+    for (size_t i = 0; i < hash->num_large; i++) {
+        size_t large = hash->large_items[i];
+        for (size_t item = 0; item < hash->num_items; item++) {
+            if (item != large) {
+                try_pair(hash, large, item);
+            }
+        }
+    }
+    return hash->num_pairs;
+}
+
+bool spatial_hash_has_pair(spatial_hash_t *hash, void *value1, void *value2) {
+    if (hash->num_pairs == 0) {
+        return false;
+    }
+    hash_pair_t pair = make_pair(value1, value2);
+    size_t slot = pair_slot(pair, hash->pair_capacity);
+    while (hash->pairs[slot].first != NULL) {
+        if (hash->pairs[slot].first == pair.first && hash->pairs[slot].second == pair.second) {
+            return true;
+        }
+        slot = (slot + 1) & (hash->pair_capacity - 1);
+    }
+    return false;
+}
+
+/**
+ * Appends an item to results if its box overlaps box and it was not already
+ * appended during the current query.
+ */
+static size_t query_item(spatial_hash_t *hash, size_t item, bounding_box_t box, list_t *results) {
+    hash_item_t *entry = &hash->items[item];
+    if (entry->stamp == hash->stamp || !bounding_box_overlap(entry->box, box)) {
+        return 0;
+    }
+    entry->stamp = hash->stamp;
+    list_add(results, entry->value);
+    return 1;
+}
+
+/**
+ * Finds the entries of the sorted cell array that are in cell (x, y).
+ *
+ * @return the index of the first entry in the cell; end is set to one past the last
+ */
+static size_t find_cell(spatial_hash_t *hash, long x, long y, size_t *end) {
+    // Binary search for the first entry in cell (x, y)
+    size_t low = 0, high = hash->num_cells;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        cell_entry_t *cell = &hash->cells[mid];
+        if (cell->x < x || (cell->x == x && cell->y < y)) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    size_t last = low;
+    while (last < hash->num_cells && hash->cells[last].x == x && hash->cells[last].y == y) {
+        last++;
+    }
+    *end = last;
+    return low;
+}
+
+size_t spatial_hash_query(spatial_hash_t *hash, bounding_box_t box, list_t *results) {
+    sort_cells(hash);
+    hash->stamp++;
+    size_t found = 0;
+
+    long min_x = cell_coord(hash, box.min.x), max_x = cell_coord(hash, box.max.x);
+    long min_y = cell_coord(hash, box.min.y), max_y = cell_coord(hash, box.max.y);
+    double covered = ((double) (max_x - min_x) + 1) * ((double) (max_y - min_y) + 1);
+    if (covered > hash->num_cells) {
+        // Visiting every covered cell would cost more than checking every value
+        for (size_t item = 0; item < hash->num_items; item++) {
+            found += query_item(hash, item, box, results);
+        }
+        return found;
+    }
+
+    for (long x = min_x; x <= max_x; x++) {
+        for (long y = min_y; y <= max_y; y++) {
+            size_t end;
+            for (size_t i = find_cell(hash, x, y, &end); i < end; i++) {
+                found += query_item(hash, hash->cells[i].item, box, results);
+            }
+        }
+    }
+    for (size_t i = 0; i < hash->num_large; i++) {
+        found += query_item(hash, hash->large_items[i], box, results);
+    }
+    return found;
+}
+
+/**
+ * Adds the pair of an item and a value of another hash if their boxes overlap
+ * and the value was not already compared during the current search of other.
+ */
+static void pair_across(spatial_hash_t *hash, hash_item_t *item, spatial_hash_t *other,
+                        size_t other_item) {
+    hash_item_t *entry = &other->items[other_item];
+    if (entry->stamp == other->stamp) {
+        return;
+    }
+    entry->stamp = other->stamp;
+    if (entry->value != item->value && bounding_box_overlap(item->box, entry->box)) {
+        add_pair(hash, item->value, entry->value);
+    }
+}
+
+size_t spatial_hash_find_pairs_with(spatial_hash_t *hash, spatial_hash_t *other) {
+    sort_cells(other);
+    for (size_t item = 0; item < hash->num_items; item++) {
+        hash_item_t *entry = &hash->items[item];
+        bounding_box_t box = entry->box;
+        other->stamp++;
+
+        long min_x = cell_coord(other, box.min.x), max_x = cell_coord(other, box.max.x);
+        long min_y = cell_coord(other, box.min.y), max_y = cell_coord(other, box.max.y);
+        double covered = ((double) (max_x - min_x) + 1) * ((double) (max_y - min_y) + 1);
+        if (covered > SPATIAL_HASH_MAX_CELLS_PER_ITEM || covered > other->num_cells) {
+            // Visiting every covered cell would cost more than checking every value
+            for (size_t other_item = 0; other_item < other->num_items; other_item++) {
+                pair_across(hash, entry, other, other_item);
+            }
+            continue;
+        }
+        for (long x = min_x; x <= max_x; x++) {
+            for (long y = min_y; y <= max_y; y++) {
+                size_t end;
+                for (size_t i = find_cell(other, x, y, &end); i < end; i++) {
+                    pair_across(hash, entry, other, other->cells[i].item);
+                }
+            }
+        }
+        for (size_t i = 0; i < other->num_large; i++) {
+            pair_across(hash, entry, other, other->large_items[i]);
+        }
+    }
+    return hash->num_pairs;
+}
+
+/**
+ * Returns whether the segment from start to end passes through a box,
+ * by clipping it against the box's slabs along each axis.
+ */
+static bool segment_hits_box(vector_t start, vector_t end, bounding_box_t box) {
+    double enter = 0, exit = 1;
+    double starts[2] = {start.x, start.y}, deltas[2] = {end.x - start.x, end.y - start.y};
+    double mins[2] = {box.min.x, box.min.y}, maxes[2] = {box.max.x, box.max.y};
+    for (size_t axis = 0; axis < 2; axis++) {
+        if (deltas[axis] == 0) {
+            if (starts[axis] < mins[axis] || starts[axis] > maxes[axis]) {
+                return false;
+            }
+            continue;
+        }
+        double near = (mins[axis] - starts[axis]) / deltas[axis];
+        double far = (maxes[axis] - starts[axis]) / deltas[axis];
+        if (near > far) {
+            double swap = near;
+            near = far;
+            far = swap;
+        }
+        enter = fmax(enter, near);
+        exit = fmin(exit, far);
+        if (enter > exit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Appends an item to results if its box touches the segment and it was not
+ * already appended during the current query.
+ */
+static size_t query_segment_item(spatial_hash_t *hash, size_t item, vector_t start, vector_t end,
+                                 list_t *results) {
+    hash_item_t *entry = &hash->items[item];
+    if (entry->stamp == hash->stamp || !segment_hits_box(start, end, entry->box)) {
+        return 0;
+    }
+    entry->stamp = hash->stamp;
+    list_add(results, entry->value);
+    return 1;
+}
+
+size_t spatial_hash_query_segment(spatial_hash_t *hash, vector_t start, vector_t end,
+                                  list_t *results) {
+    sort_cells(hash);
+    hash->stamp++;
+    size_t found = 0;
+
+    long x = cell_coord(hash, start.x), y = cell_coord(hash, start.y);
+    long end_x = cell_coord(hash, end.x), end_y = cell_coord(hash, end.y);
+    double crossed = fabs((double) (end_x - x)) + fabs((double) (end_y - y)) + 1;
+    if (crossed > hash->num_cells) {
+        // Walking every crossed cell would cost more than checking every value
+        for (size_t item = 0; item < hash->num_items; item++) {
+            found += query_segment_item(hash, item, start, end, results);
+        }
+        return found;
+    }
+
+    // Walk the cells the segment crosses in order (Amanatides and Woo)
+    vector_t delta = vec_subtract(end, start);
+    long step_x = delta.x > 0 ? 1 : -1, step_y = delta.y > 0 ? 1 : -1;
+    // The fraction of the segment at which it crosses into the next column or row
+    double next_x = INFINITY, next_y = INFINITY;
+    double per_x = INFINITY, per_y = INFINITY;
+    if (delta.x != 0) {
+        double boundary = (x + (step_x > 0)) * hash->cell_size;
+        next_x = (boundary - start.x) / delta.x;
+        per_x = hash->cell_size / fabs(delta.x);
+    }
+    if (delta.y != 0) {
+        double boundary = (y + (step_y > 0)) * hash->cell_size;
+        next_y = (boundary - start.y) / delta.y;
+        per_y = hash->cell_size / fabs(delta.y);
+    }
+    for (size_t visited = 0; visited < (size_t) crossed; visited++) {
+        size_t cell_end;
+        for (size_t i = find_cell(hash, x, y, &cell_end); i < cell_end; i++) {
+            found += query_segment_item(hash, hash->cells[i].item, start, end, results);
+        }
+        if (x == end_x && y == end_y) {
+            break;
+        }
+        if (next_x < next_y) {
+            x += step_x;
+            next_x += per_x;
+        }
+        else {
+            y += step_y;
+            next_y += per_y;
+        }
+    }
+    for (size_t i = 0; i < hash->num_large; i++) {
+        found += query_segment_item(hash, hash->large_items[i], start, end, results);
+    }
+    return found;
+}
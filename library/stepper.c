@@ -0,0 +1,50 @@
+#include "stepper.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+typedef struct stepper {
+    double step;
+    size_t max_steps;
+    // Time that has elapsed but not yet been simulated
+    double accumulator;
+} stepper_t;
+
+stepper_t *stepper_init(double step, size_t max_steps) {
+    assert(step > 0);
+    assert(max_steps >= 1);
+    stepper_t *stepper = malloc(sizeof(stepper_t));
+    assert(stepper != NULL && "Could not allocate memory for a new stepper_t.");
+    stepper->step = step;
+    stepper->max_steps = max_steps;
+    stepper->accumulator = 0;
+    return stepper;
+}
+
+void stepper_free(stepper_t *stepper) {
+    free(stepper);
+}
+
+double stepper_get_step(stepper_t *stepper) {
+    return stepper->step;
+}
+
+size_t stepper_advance(stepper_t *stepper, scene_t *scene, double elapsed) {
+    assert(elapsed >= 0);
+    stepper->accumulator += elapsed;
+    size_t steps = 0;
+    while (stepper->accumulator >= stepper->step && steps < stepper->max_steps) {
+        scene_tick(scene, stepper->step);
+        stepper->accumulator -= stepper->step;
+        steps++;
+    }
+    if (stepper->accumulator >= stepper->step) {
+        // Fell too far behind, so drop the whole steps that are left
+        stepper->accumulator = fmod(stepper->accumulator, stepper->step);
+    }
+    return steps;
+}
+
+double stepper_get_alpha(stepper_t *stepper) {
+    return stepper->accumulator / stepper->step;
+}
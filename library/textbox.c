@@ -1,26 +1,116 @@
+#include "textbox.h"
+#include "list.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 
+// Bumped by textbox_invalidate_textures(), so textures from older renderers are not reused
+static size_t texture_generation = 0;
+
+/**
+ * An opened font file at one point size, shared by every textbox using it.
+ */
+typedef struct font_asset {
+    char *path;
+    int size;
+    TTF_Font *font;
+    // The number of textboxes using the font; it is closed when this reaches 0
+    size_t references;
+} font_asset_t;
+
+// Every font with at least one reference, searched by path and size
+static list_t *fonts = NULL;
+
 typedef struct textbox {
     int x;
     int y;
     int width;
     int height;
     char *text;
-    TTF_Font *font;
+    font_asset_t *font;
     SDL_Color color;
+    // The rendered text, or NULL until it is first drawn or after it changes
+    SDL_Texture *texture;
+    size_t texture_generation;
 } textbox_t;
 
-textbox_t *textbox_init(int x, int y, int width, int height, char *text, TTF_Font *font, SDL_Color color) {
+/**
+ * Returns the font at path and size, opening the file if no textbox uses it yet.
+ */
+static font_asset_t *font_acquire(char *path, int size) {
+    if (fonts == NULL) {
+        fonts = list_init(4, NULL);
+    }
+    for (size_t i = 0; i < list_size(fonts); i++) {
+        font_asset_t *font = list_get(fonts, i);
+        if (font->size == size && strcmp(font->path, path) == 0) {
+            font->references++;
+            return font;
+        }
+    }
+    font_asset_t *font = malloc(sizeof(font_asset_t));
+    assert(font != NULL && "Could not allocate memory for a new font");
+    font->font = TTF_OpenFont(path, size);
+    assert(font->font != NULL && "Could not open font");
+    font->path = malloc(strlen(path) + 1);
+    strcpy(font->path, path);
+    font->size = size;
+    font->references = 1;
+    list_add(fonts, font);
+    return font;
+}
+
+/**
+ * Drops one reference to font, closing it once no textbox uses it.
+ */
+static void font_release(font_asset_t *font) {
+    if (--font->references > 0) {
+        return;
+    }
+    list_remove(fonts, list_index_of(fonts, font));
+    TTF_CloseFont(font->font);
+    free(font->path);
+    free(font);
+    if (list_size(fonts) == 0) {
+        list_free(fonts);
+        fonts = NULL;
+    }
+}
+
+/**
+ * Returns whether the textbox's texture is up to date and belongs to the current renderer.
+ */
+static bool textbox_has_texture(textbox_t *textbox) {
+    return textbox->texture != NULL && textbox->texture_generation == texture_generation;
+}
+
+/**
+ * Discards the rendered text so it is rendered again when next drawn.
+ */
+static void textbox_clear_texture(textbox_t *textbox) {
+    if (textbox_has_texture(textbox)) {
+        SDL_DestroyTexture(textbox->texture);
+    }
+    textbox->texture = NULL;
+}
+
+textbox_t *textbox_init(int x, int y, int width, int height, char *text, char *font_path, int font_size,
+                        SDL_Color color) {
     textbox_t *new_textbox = malloc(sizeof(textbox_t));
+    assert(new_textbox != NULL && "Could not allocate memory for a new textbox");
     new_textbox->x = x;
     new_textbox->y = y;
     new_textbox->width = width;
     new_textbox->height = height;
-    new_textbox->text = text;
-    new_textbox->width = width;
-    new_textbox->font = font;
+    new_textbox->text = malloc(strlen(text) + 1);
+    strcpy(new_textbox->text, text);
+    new_textbox->font = font_acquire(font_path, font_size);
     new_textbox->color = color;
+    new_textbox->texture = NULL;
+    new_textbox->texture_generation = texture_generation;
     return new_textbox;
 }
 
@@ -44,16 +134,65 @@ char *textbox_get_text(textbox_t *textbox) {
     return textbox->text;
 }
 
+void textbox_set_text(textbox_t *textbox, char *text) {
+    if (strcmp(textbox->text, text) == 0) {
+        return;
+    }
+    free(textbox->text);
+    textbox->text = malloc(strlen(text) + 1);
+    strcpy(textbox->text, text);
+    textbox_clear_texture(textbox);
+}
+
 TTF_Font *textbox_get_font(textbox_t *textbox) {
-    return textbox->font;
+    return textbox->font->font;
+}
+
+void textbox_set_font(textbox_t *textbox, char *font_path, int font_size) {
+    font_asset_t *font = font_acquire(font_path, font_size);
+    font_release(textbox->font);
+    if (font != textbox->font) {
+        textbox->font = font;
+        textbox_clear_texture(textbox);
+    }
 }
 
 SDL_Color textbox_get_color(textbox_t *textbox) {
     return textbox->color;
 }
 
+void textbox_set_color(textbox_t *textbox, SDL_Color color) {
+    SDL_Color old = textbox->color;
+    if (old.r == color.r && old.g == color.g && old.b == color.b && old.a == color.a) {
+        return;
+    }
+    textbox->color = color;
+    textbox_clear_texture(textbox);
+}
+
+SDL_Texture *textbox_get_texture(textbox_t *textbox, SDL_Renderer *renderer) {
+    if (!textbox_has_texture(textbox)) {
+        SDL_Surface *surface = TTF_RenderText_Solid(textbox->font->font, textbox->text, textbox->color);
+        assert(surface != NULL && "Could not render textbox text");
+        textbox->texture = SDL_CreateTextureFromSurface(renderer, surface);
+        assert(textbox->texture != NULL && "Could not create SDL_Texture from textbox text");
+        textbox->texture_generation = texture_generation;
+        SDL_FreeSurface(surface);
+    }
+    return textbox->texture;
+}
+
+void textbox_invalidate_textures(void) {
+    texture_generation++;
+}
+
+size_t textbox_num_fonts(void) {
+    return fonts == NULL ? 0 : list_size(fonts);
+}
+
 void textbox_free(textbox_t *textbox) {
-    TTF_CloseFont(textbox->font);
+    textbox_clear_texture(textbox);
+    font_release(textbox->font);
+    free(textbox->text);
     free(textbox);
 }
-
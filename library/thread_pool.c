@@ -0,0 +1,141 @@
+#include "thread_pool.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#define THREAD_POOL_HAS_THREADS
+#endif
+
+typedef struct thread_pool {
+    size_t size;
+#ifdef THREAD_POOL_HAS_THREADS
+    pthread_t *workers;
+    pthread_mutex_t lock;
+    // Signalled when a batch starts or the pool stops
+    pthread_cond_t batch_ready;
+    // Signalled when the last task of a batch finishes
+    pthread_cond_t batch_done;
+    // The current batch; batch counts batches so workers notice new ones
+    size_t batch;
+    thread_task_t task;
+    void *aux;
+    size_t num_tasks;
+    size_t next_task;
+    size_t unfinished;
+    bool stopping;
+#endif
+} thread_pool_t;
+
+#ifdef THREAD_POOL_HAS_THREADS
+/**
+ * Runs tasks of the current batch until none are left to claim.
+ * Must be called with the lock held, and returns with it held.
+ */
+static void run_tasks(thread_pool_t *pool) {
+    while (pool->next_task < pool->num_tasks) {
+        size_t index = pool->next_task++;
+        pthread_mutex_unlock(&pool->lock);
+        pool->task(index, pool->aux);
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->unfinished == 0) {
+            pthread_cond_broadcast(&pool->batch_done);
+        }
+    }
+}
+
+static void *worker_main(void *arg) {
+    thread_pool_t *pool = arg;
+    size_t seen_batch = 0;
+    pthread_mutex_lock(&pool->lock);
+    while (true) {
+        while (!pool->stopping && pool->batch == seen_batch) {
+            pthread_cond_wait(&pool->batch_ready, &pool->lock);
+        }
+        if (pool->stopping) {
+            break;
+        }
+        seen_batch = pool->batch;
+        run_tasks(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+#endif
+
+thread_pool_t *thread_pool_init(size_t size) {
+    assert(size >= 1);
+    thread_pool_t *pool = malloc(sizeof(thread_pool_t));
+    assert(pool != NULL && "Could not allocate memory for a new thread_pool_t.");
+#ifdef THREAD_POOL_HAS_THREADS
+    pool->size = size;
+    pool->workers = malloc(sizeof(pthread_t) * (size - 1));
+    assert(pool->workers != NULL && "Could not allocate memory for thread pool workers.");
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->batch_ready, NULL);
+    pthread_cond_init(&pool->batch_done, NULL);
+    pool->batch = 0;
+    pool->task = NULL;
+    pool->aux = NULL;
+    pool->num_tasks = 0;
+    pool->next_task = 0;
+    pool->unfinished = 0;
+    pool->stopping = false;
+    for (size_t i = 0; i + 1 < size; i++) {
+        int error = pthread_create(&pool->workers[i], NULL, worker_main, pool);
+        assert(error == 0 && "Could not start a thread pool worker.");
+    }
+#else
+    pool->size = 1;
+#endif
+    return pool;
+}
+
+void thread_pool_free(thread_pool_t *pool) {
+#ifdef THREAD_POOL_HAS_THREADS
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->batch_ready);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i + 1 < pool->size; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+    pthread_cond_destroy(&pool->batch_done);
+    pthread_cond_destroy(&pool->batch_ready);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+#endif
+    free(pool);
+}
+
+size_t thread_pool_size(thread_pool_t *pool) {
+    return pool->size;
+}
+
+void thread_pool_run(thread_pool_t *pool, size_t num_tasks, thread_task_t task, void *aux) {
+    if (num_tasks == 0) {
+        return;
+    }
+#ifdef THREAD_POOL_HAS_THREADS
+    if (pool->size > 1 && num_tasks > 1) {
+        pthread_mutex_lock(&pool->lock);
+        pool->task = task;
+        pool->aux = aux;
+        pool->num_tasks = num_tasks;
+        pool->next_task = 0;
+        pool->unfinished = num_tasks;
+        pool->batch++;
+        pthread_cond_broadcast(&pool->batch_ready);
+        run_tasks(pool);
+        while (pool->unfinished > 0) {
+            pthread_cond_wait(&pool->batch_done, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < num_tasks; i++) {
+        task(i, aux);
+    }
+}
@@ -0,0 +1,82 @@
+#include "animation.h"
+#include "test_util.h"
+#include <assert.h>
+
+// Three frames shown for 1, 2 and 1 seconds
+animation_t *make_animation(animation_mode_t mode, image_t **frames) {
+    animation_t *animation = animation_init(mode);
+    char *names[] = {"images/floor.png", "images/lava.png", "images/ground.png"};
+    double durations[] = {1, 2, 1};
+    for (size_t i = 0; i < 3; i++) {
+        frames[i] = image_init(names[i], (vector_t) {10, 10}, 0);
+        animation_add_frame(animation, frames[i], durations[i]);
+    }
+    return animation;
+}
+
+void test_loop() {
+    image_t *frames[3];
+    animation_t *animation = make_animation(ANIMATION_LOOP, frames);
+    assert(animation_num_frames(animation) == 3);
+    assert(isclose(animation_get_duration(animation), 4));
+    assert(animation_is_animated(animation));
+    assert(animation_get_frame(animation, 0) == frames[0]);
+    assert(animation_get_frame(animation, 0.5) == frames[0]);
+    assert(animation_get_frame(animation, 1) == frames[1]);
+    assert(animation_get_frame(animation, 2.9) == frames[1]);
+    assert(animation_get_frame(animation, 3.5) == frames[2]);
+    assert(animation_get_frame(animation, 4.5) == frames[0]);
+    assert(animation_get_frame(animation, 401.5) == frames[1]);
+    animation_free(animation);
+}
+
+void test_once() {
+    image_t *frames[3];
+    animation_t *animation = make_animation(ANIMATION_ONCE, frames);
+    assert(animation_get_frame(animation, 1.5) == frames[1]);
+    assert(animation_get_frame(animation, 4) == frames[2]);
+    assert(animation_get_frame(animation, 100) == frames[2]);
+    animation_free(animation);
+}
+
+void test_ping_pong() {
+    image_t *frames[3];
+    animation_t *animation = make_animation(ANIMATION_PING_PONG, frames);
+    assert(animation_get_frame(animation, 0.5) == frames[0]);
+    assert(animation_get_frame(animation, 3.5) == frames[2]);
+    // Played backwards after the first pass
+    assert(animation_get_frame(animation, 4.5) == frames[2]);
+    assert(animation_get_frame(animation, 5.5) == frames[1]);
+    assert(animation_get_frame(animation, 7.5) == frames[0]);
+    assert(animation_get_frame(animation, 8.5) == frames[0]);
+    assert(animation_get_frame(animation, 9.5) == frames[1]);
+    animation_free(animation);
+}
+
+void test_still() {
+    image_t *image = image_init("images/floor.png", (vector_t) {10, 10}, 0);
+    animation_t *animation = animation_init_still(image);
+    assert(animation_num_frames(animation) == 1);
+    assert(!animation_is_animated(animation));
+    assert(animation_get_frame(animation, 0) == image);
+    assert(animation_get_frame(animation, 1e6) == image);
+    animation_free(animation);
+    assert(image_num_assets() == 0);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_loop)
+    DO_TEST(test_once)
+    DO_TEST(test_ping_pong)
+    DO_TEST(test_still)
+
+    puts("animation_test PASS");
+}
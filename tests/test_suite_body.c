@@ -241,6 +241,173 @@ void test_body_info_freer() {
     body_free(body);
 }
 
+void test_body_shape_view() {
+    list_t *shape = list_init(3, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t) {+1, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {0, +1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t) {-1, 0};
+    list_add(shape, v);
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(body, (vector_t) {1, 2});
+    body_set_rotation(body, M_PI / 2);
+
+    // The view borrows the body's vertices, so it matches a copied shape
+    // and does not change between calls
+    polygon_view_t view = body_get_shape_view(body);
+    assert(view.size == 3);
+    assert(view.points == body_get_shape_view(body).points);
+    list_t *copy = body_get_shape(body);
+    for (size_t i = 0; i < view.size; i++) {
+        assert(vec_equal(view.points[i], *(vector_t *) list_get(copy, i)));
+    }
+    list_free(copy);
+    body_free(body);
+}
+void test_body_large_shape() {
+    // More vertices than are stored inline in the body
+    const size_t SIDES = 40;
+    list_t *shape = list_init(SIDES, free);
+    for (size_t i = 0; i < SIDES; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = vec_rotate((vector_t) {10, 0}, 2 * M_PI * i / SIDES);
+        list_add(shape, v);
+    }
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(body, (vector_t) {5, 5});
+    polygon_view_t view = body_get_shape_view(body);
+    assert(view.size == SIDES);
+    assert(vec_isclose(view.points[0], (vector_t) {15, 5}));
+    bounding_box_t box = body_get_bounding_box(body);
+    assert(isclose(box.min.x, -5) && isclose(box.max.x, 15));
+    body_free(body);
+}
+void test_body_redefine_centroid() {
+    list_t *shape = list_init(4, free);
+    vector_t corners[] = {{0, 0}, {2, 0}, {2, 2}, {0, 2}};
+    for (size_t i = 0; i < 4; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = corners[i];
+        list_add(shape, v);
+    }
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    body_set_rotation(body, M_PI / 2);
+    // Moving the centroid leaves the vertices in place
+    body_redefine_centroid(body, (vector_t) {0, 0});
+    polygon_view_t view = body_get_shape_view(body);
+    for (size_t i = 0; i < 4; i++) {
+        assert(vec_isclose(view.points[i], corners[(i + 1) % 4]));
+    }
+    // and rotations are now about the new centroid
+    body_set_rotation(body, M_PI);
+    view = body_get_shape_view(body);
+    assert(vec_isclose(view.points[2], (vector_t) {-2, 0}));
+
+    // A body that does not move keeps the same vertices between ticks
+    body_tick(body, 1);
+    assert(body_get_shape_view(body).points[2].x == view.points[2].x);
+    body_free(body);
+}
+void test_body_bounding_box() {
+    list_t *shape = list_init(4, free);
+    vector_t corners[] = {{0, 0}, {4, 0}, {4, 2}, {0, 2}};
+    for (size_t i = 0; i < 4; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = corners[i];
+        list_add(shape, v);
+    }
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    bounding_box_t box = body_get_bounding_box(body);
+    assert(vec_equal(box.min, (vector_t) {0, 0}) && vec_equal(box.max, (vector_t) {4, 2}));
+
+    body_set_centroid(body, (vector_t) {10, 10});
+    box = body_get_bounding_box(body);
+    assert(vec_equal(box.min, (vector_t) {8, 9}) && vec_equal(box.max, (vector_t) {12, 11}));
+
+    body_set_rotation(body, M_PI / 2);
+    box = body_get_bounding_box(body);
+    assert(vec_isclose(box.min, (vector_t) {9, 8}) && vec_isclose(box.max, (vector_t) {11, 12}));
+
+    // The cached box always matches the body's vertices
+    body_set_centroid(body, (vector_t) {-3, 5});
+    polygon_view_t view = body_get_shape_view(body);
+    bounding_box_t expected = polygon_points_bounding_box(view.points, view.size);
+    box = body_get_bounding_box(body);
+    assert(vec_equal(box.min, expected.min) && vec_equal(box.max, expected.max));
+    body_free(body);
+}
+void test_body_interpolation() {
+    list_t *shape = list_init(4, free);
+    vector_t corners[] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    for (size_t i = 0; i < 4; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = corners[i];
+        list_add(shape, v);
+    }
+    body_t *body = body_init(shape, 1, (rgb_color_t) {0, 0, 0});
+    vector_t buffer[4];
+    assert(body_get_num_vertices(body) == 4);
+    // A body that has not ticked is drawn where it is
+    body_set_centroid(body, (vector_t) {2, 0});
+    assert(vec_equal(body_get_interpolated_centroid(body, 0.5), (vector_t) {2, 0}));
+    assert(body_get_interpolated_shape(body, 0.5, buffer).points != buffer);
+
+    body_set_velocity(body, (vector_t) {4, 0});
+    body_set_passive_rotation(body, M_PI);
+    body_tick(body, 0.5);
+    assert(vec_isclose(body_get_interpolated_centroid(body, 0), (vector_t) {2, 0}));
+    assert(vec_isclose(body_get_interpolated_centroid(body, 0.25), (vector_t) {2.5, 0}));
+    assert(vec_isclose(body_get_interpolated_centroid(body, 1), (vector_t) {4, 0}));
+    // Halfway through the tick the square has turned by an eighth of a turn
+    polygon_view_t view = body_get_interpolated_shape(body, 0.5, buffer);
+    assert(view.points == buffer && view.size == 4);
+    assert(vec_isclose(view.points[0], (vector_t) {3, -sqrt(2)}));
+    // and the end of the tick is the body's current shape
+    view = body_get_interpolated_shape(body, 1, buffer);
+    assert(view.points == body_get_shape_view(body).points);
+
+    // Teleporting skips the interpolation
+    body_set_centroid(body, (vector_t) {-10, 0});
+    assert(vec_equal(body_get_interpolated_centroid(body, 0.5), (vector_t) {-10, 0}));
+    body_free(body);
+}
+
+void test_body_animation() {
+    list_t *shape = list_init(4, free);
+    vector_t corners[] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    for (size_t i = 0; i < 4; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = corners[i];
+        list_add(shape, v);
+    }
+    body_t *body = body_init(shape, INFINITY, (rgb_color_t) {0, 0, 0});
+    assert(!body_has_image(body));
+    image_t *still = image_init("images/floor.png", (vector_t) {2, 2}, 0);
+    body_set_animation(body, animation_init_still(still));
+    assert(body_has_image(body));
+    // A body whose image never changes can still be static
+    assert(body_classify(body) == BODY_STATIC);
+
+    animation_t *animation = animation_init(ANIMATION_LOOP);
+    image_t *first = image_init("images/floor.png", (vector_t) {2, 2}, 0);
+    image_t *second = image_init("images/lava.png", (vector_t) {2, 2}, 0);
+    animation_add_frame(animation, first, 1);
+    animation_add_frame(animation, second, 0.5);
+    body_set_animation(body, animation);
+    assert(body_classify(body) == BODY_DYNAMIC);
+    assert(body_get_current_image(body) == first);
+    body_tick(body, 1.25);
+    assert(body_get_current_image(body) == second);
+    body_tick(body, 0.5);
+    assert(body_get_current_image(body) == first);
+    body_free(body);
+    assert(image_num_assets() == 0);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -258,6 +425,12 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_body_remove)
     DO_TEST(test_body_info)
     DO_TEST(test_body_info_freer)
+    DO_TEST(test_body_shape_view)
+    DO_TEST(test_body_large_shape)
+    DO_TEST(test_body_redefine_centroid)
+    DO_TEST(test_body_bounding_box)
+    DO_TEST(test_body_interpolation)
+    DO_TEST(test_body_animation)
 
     puts("body_test PASS");
 }
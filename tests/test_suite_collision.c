@@ -1,3 +1,203 @@
+#include "collision.h"
+#include "polygon.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+// Makes a regular polygon with n vertices in counterclockwise order
+list_t *make_regular_polygon(size_t n, double radius, vector_t center) {
+    list_t *shape = list_init(n, (free_func_t) vec_free);
+    for (size_t i = 0; i < n; i++) {
+        double angle = 2 * M_PI * i / n;
+        vector_t *v = malloc(sizeof(*v));
+        *v = (vector_t) {center.x + radius * cos(angle), center.y + radius * sin(angle)};
+        list_add(shape, v);
+    }
+    return shape;
+}
+
+void test_separated_squares() {
+    list_t *square1 = make_regular_polygon(4, 1, VEC_ZERO);
+    list_t *square2 = make_regular_polygon(4, 1, (vector_t) {5, 0});
+    assert(!find_collision(square1, square2).collided);
+    assert(!find_collision(square2, square1).collided);
+    list_free(square1);
+    list_free(square2);
+}
+
+void test_overlapping_squares() {
+    list_t *square1 = make_regular_polygon(4, 1, VEC_ZERO);
+    list_t *square2 = make_regular_polygon(4, 1, (vector_t) {1.5, 0});
+    collision_info_t info = find_collision(square1, square2);
+    assert(info.collided);
+    assert(isclose(sqrt(vec_dot(info.axis, info.axis)), 1));
+    list_free(square1);
+    list_free(square2);
+}
+
+void test_points_match_list() {
+    // Compare the contiguous path against the list path at many offsets,
+    // including a polygon too big to fit in find_collision()'s stack buffer
+    size_t sizes[] = {3, 4, 16, 200};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        list_t *shape1 = make_regular_polygon(sizes[s], 10, VEC_ZERO);
+        vector_t *points1 = malloc(sizeof(vector_t) * sizes[s]);
+        for (size_t i = 0; i < sizes[s]; i++) {
+            points1[i] = *(vector_t *) list_get(shape1, i);
+        }
+        for (int x = -25; x <= 25; x += 5) {
+            list_t *shape2 = make_regular_polygon(4, 5, (vector_t) {x, x / 2.0});
+            vector_t points2[4];
+            for (size_t i = 0; i < 4; i++) {
+                points2[i] = *(vector_t *) list_get(shape2, i);
+            }
+            collision_info_t from_list = find_collision(shape1, shape2);
+            collision_info_t from_points = find_collision_points(points1, sizes[s], points2, 4);
+            assert(from_list.collided == from_points.collided);
+            assert(vec_equal(from_list.axis, from_points.axis));
+            list_free(shape2);
+        }
+        free(points1);
+        list_free(shape1);
+    }
+}
+
+void test_circles() {
+    collision_info_t info = find_circle_collision(VEC_ZERO, 1, (vector_t) {1.5, 0}, 1);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t) {1, 0}));
+    // Touching circles do not collide
+    assert(!find_circle_collision(VEC_ZERO, 1, (vector_t) {0, 2}, 1).collided);
+}
+
+void test_circle_polygon() {
+    // Axis-aligned square from (-1, -1) to (1, 1)
+    vector_t square[] = {{1, -1}, {1, 1}, {-1, 1}, {-1, -1}};
+    collision_info_t info = find_circle_polygon_collision((vector_t) {1.5, 0}, 1, square, 4);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t) {-1, 0}));
+
+    // Near a corner, the circle only collides if it reaches the corner itself
+    assert(!find_circle_polygon_collision((vector_t) {1.8, 1.8}, 1, square, 4).collided);
+    info = find_circle_polygon_collision((vector_t) {1.5, 1.5}, 1, square, 4);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t) {-sqrt(0.5), -sqrt(0.5)}));
+
+    // A circle whose center is inside the polygon always collides
+    info = find_circle_polygon_collision((vector_t) {0.5, 0}, 0.1, square, 4);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t) {-1, 0}));
+}
+
+void test_circle_bodies() {
+    body_t *ball = body_init_circle((vector_t) {0, 3}, 1, 1, (rgb_color_t) {0, 0, 0}, NULL, NULL);
+    body_t *wall = body_init(make_regular_polygon(4, sqrt(2), VEC_ZERO), INFINITY, (rgb_color_t) {0, 0, 0});
+    body_set_rotation(wall, M_PI / 4);
+    assert(body_is_circle(ball) && !body_is_circle(wall));
+    assert(!find_body_collision(ball, wall).collided);
+
+    body_set_centroid(ball, (vector_t) {0, 1.5});
+    collision_info_t info = find_body_collision(ball, wall);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t) {0, -1}));
+    // Swapping the bodies flips the axis
+    info = find_body_collision(wall, ball);
+    assert(vec_isclose(info.axis, (vector_t) {0, 1}));
+    body_free(ball);
+    body_free(wall);
+}
+void test_swept_squares() {
+    vector_t square[] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    // A thin wall that the square jumps over entirely
+    vector_t wall[] = {{4.9, -5}, {5.1, -5}, {5.1, 5}, {4.9, 5}};
+    assert(!find_collision_points(square, 4, wall, 4).collided);
+    sweep_info_t info = find_swept_collision_points(square, 4, (vector_t) {20, 0}, wall, 4);
+    assert(info.collided);
+    // The square's right edge reaches the wall after moving 3.9
+    assert(isclose(info.time, 3.9 / 20));
+    assert(vec_isclose(info.axis, (vector_t) {1, 0}));
+
+    // Moving away, stopping short, or passing beside the wall misses it
+    assert(!find_swept_collision_points(square, 4, (vector_t) {-20, 0}, wall, 4).collided);
+    assert(!find_swept_collision_points(square, 4, (vector_t) {3, 0}, wall, 4).collided);
+    assert(!find_swept_collision_points(square, 4, (vector_t) {20, 40}, wall, 4).collided);
+    // Sliding along an edge without overlapping does not count
+    vector_t floor[] = {{-5, -2}, {5, -2}, {5, -1}, {-5, -1}};
+    assert(!find_swept_collision_points(square, 4, (vector_t) {3, 0}, floor, 4).collided);
+
+    // Shapes that already overlap collide at the start
+    info = find_swept_collision_points(square, 4, (vector_t) {1, 0}, square, 4);
+    assert(info.collided && info.time == 0);
+}
+
+void test_body_sweep() {
+    body_t *bullet = body_init_circle((vector_t) {-5, 0}, 0.5, 1, (rgb_color_t) {0, 0, 0}, NULL, NULL);
+    body_t *wall = body_init(make_regular_polygon(4, 1, VEC_ZERO), INFINITY, (rgb_color_t) {0, 0, 0});
+    body_set_velocity(bullet, (vector_t) {100, 0});
+    body_tick(bullet, 0.1);
+    assert(vec_isclose(body_get_last_motion(bullet), (vector_t) {10, 0}));
+    assert(!find_body_collision(bullet, wall).collided);
+    bounding_box_t box = body_get_swept_bounding_box(bullet);
+    assert(isclose(box.min.x, -5.5) && isclose(box.max.x, 5.5));
+
+    sweep_info_t info = find_body_sweep(bullet, wall);
+    assert(info.collided);
+    assert(isclose(info.time, 0.35));
+    // The order of the bodies only flips the axis
+    sweep_info_t flipped = find_body_sweep(wall, bullet);
+    assert(flipped.collided && isclose(flipped.time, info.time));
+    assert(vec_isclose(flipped.axis, vec_negate(info.axis)));
+
+    // Teleporting is not a motion
+    body_set_centroid(bullet, (vector_t) {-5, 0});
+    assert(!find_body_sweep(bullet, wall).collided);
+    body_free(bullet);
+    body_free(wall);
+}
+void test_ray_hits() {
+    vector_t square[] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    ray_hit_t hit = find_ray_polygon_hit((vector_t) {-5, 0.5}, (vector_t) {1, 0}, 10, square, 4);
+    assert(hit.hit && isclose(hit.distance, 4));
+    assert(vec_isclose(hit.point, (vector_t) {-1, 0.5}));
+    assert(vec_isclose(hit.normal, (vector_t) {-1, 0}));
+    // Clockwise vertices give the same normal
+    vector_t clockwise[] = {{-1, 1}, {1, 1}, {1, -1}, {-1, -1}};
+    hit = find_ray_polygon_hit((vector_t) {-5, 0.5}, (vector_t) {1, 0}, 10, clockwise, 4);
+    assert(hit.hit && vec_isclose(hit.normal, (vector_t) {-1, 0}));
+    // Too short, pointing away, passing beside, or starting inside all miss
+    assert(!find_ray_polygon_hit((vector_t) {-5, 0.5}, (vector_t) {1, 0}, 3, square, 4).hit);
+    assert(!find_ray_polygon_hit((vector_t) {-5, 0.5}, (vector_t) {-1, 0}, 10, square, 4).hit);
+    assert(!find_ray_polygon_hit((vector_t) {-5, 2}, (vector_t) {1, 0}, 10, square, 4).hit);
+    assert(!find_ray_polygon_hit(VEC_ZERO, (vector_t) {1, 0}, 10, square, 4).hit);
+
+    hit = find_ray_circle_hit((vector_t) {0, 10}, (vector_t) {0, -1}, 20, (vector_t) {0, 2}, 3);
+    assert(hit.hit && isclose(hit.distance, 5));
+    assert(vec_isclose(hit.point, (vector_t) {0, 5}));
+    assert(vec_isclose(hit.normal, (vector_t) {0, 1}));
+    assert(!find_ray_circle_hit((vector_t) {0, 10}, (vector_t) {0, -1}, 4, (vector_t) {0, 2}, 3).hit);
+    assert(!find_ray_circle_hit((vector_t) {4, 10}, (vector_t) {0, -1}, 20, (vector_t) {0, 2}, 3).hit);
+    assert(!find_ray_circle_hit((vector_t) {0, 2}, (vector_t) {0, -1}, 20, (vector_t) {0, 2}, 3).hit);
+}
+
 int main(int argc, char *argv[]) {
-    
-}
\ No newline at end of file
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_separated_squares)
+    DO_TEST(test_overlapping_squares)
+    DO_TEST(test_points_match_list)
+    DO_TEST(test_circles)
+    DO_TEST(test_circle_polygon)
+    DO_TEST(test_circle_bodies)
+    DO_TEST(test_swept_squares)
+    DO_TEST(test_body_sweep)
+    DO_TEST(test_ray_hits)
+
+    puts("collision_test PASS");
+}
@@ -153,6 +153,179 @@ void test_forces_removed() {
     scene_free(scene);
 }
 
+// Tests that batched gravity moves bodies like one gravity force per pair
+void test_nbody_gravity() {
+    const size_t N = 20;
+    scene_t *paired = scene_init();
+    scene_t *batched = scene_init();
+    for (size_t i = 0; i < N; i++) {
+        vector_t centroid = {(i * 37) % 100, (i * 61) % 100};
+        body_t *body = body_init(make_shape(), 1 + i, (rgb_color_t) {0, 0, 0});
+        body_set_centroid(body, centroid);
+        for (size_t j = 0; j < i; j++) {
+            create_newtonian_gravity(paired, 10, body, scene_get_body(paired, j));
+        }
+        scene_add_body(paired, body);
+        body = body_init(make_shape(), 1 + i, (rgb_color_t) {0, 0, 0});
+        body_set_centroid(body, centroid);
+        body_set_tag(body, 'G');
+        scene_add_body(batched, body);
+    }
+    create_nbody_gravity(batched, 10, 'G', 0);
+    for (int tick = 0; tick < 10; tick++) {
+        scene_tick(paired, 1e-2);
+        scene_tick(batched, 1e-2);
+    }
+    for (size_t i = 0; i < N; i++) {
+        vector_t expected = body_get_centroid(scene_get_body(paired, i));
+        vector_t actual = body_get_centroid(scene_get_body(batched, i));
+        assert(within(1e-9, expected.x, actual.x));
+        assert(within(1e-9, expected.y, actual.y));
+    }
+
+    // Removed bodies stop attracting without recreating the force
+    body_remove(scene_get_body(batched, 0));
+    scene_tick(batched, 1e-2);
+    assert(scene_bodies(batched) == N - 1);
+    assert(list_size(scene_get_forces(batched)) == 1);
+    scene_free(paired);
+    scene_free(batched);
+}
+
+// Tests that spreading pure force creators over threads changes nothing
+void test_parallel_forces() {
+    const size_t N = 20;
+    scene_t *scenes[2] = {scene_init(), scene_init()};
+    scene_set_threads(scenes[1], 4);
+    for (size_t s = 0; s < 2; s++) {
+        for (size_t i = 0; i < N; i++) {
+            body_t *body = body_init(make_shape(), 1 + i, (rgb_color_t) {0, 0, 0});
+            body_set_centroid(body, (vector_t) {(i * 37) % 100, (i * 61) % 100});
+            for (size_t j = 0; j < i; j++) {
+                create_newtonian_gravity(scenes[s], 10, body, scene_get_body(scenes[s], j));
+                create_spring(scenes[s], 0.1, body, scene_get_body(scenes[s], j));
+            }
+            create_drag(scenes[s], 0.5, body);
+            scene_add_body(scenes[s], body);
+        }
+        // Collisions still run serially after the parallel phase
+        create_physics_collision(scenes[s], 1, scene_get_body(scenes[s], 0),
+                                 scene_get_body(scenes[s], 1));
+    }
+    for (int tick = 0; tick < 100; tick++) {
+        scene_tick(scenes[0], 1e-2);
+        scene_tick(scenes[1], 1e-2);
+    }
+    for (size_t i = 0; i < N; i++) {
+        assert(vec_equal(body_get_centroid(scene_get_body(scenes[0], i)),
+                         body_get_centroid(scene_get_body(scenes[1], i))));
+    }
+    scene_free(scenes[0]);
+    scene_free(scenes[1]);
+}
+
+// A force creator that is not marked pure: pushes a body against its velocity
+void push_back(void *aux) {
+    body_t *body = aux;
+    body_add_force(body, vec_multiply(-0.3, body_get_velocity(body)));
+}
+
+// Tests that running pure force creators before the others only changes rounding
+void test_parallel_mixed_forces() {
+    const size_t N = 20;
+    scene_t *scenes[2] = {scene_init(), scene_init()};
+    scene_set_threads(scenes[1], 4);
+    for (size_t s = 0; s < 2; s++) {
+        for (size_t i = 0; i < N; i++) {
+            body_t *body = body_init(make_shape(), 1 + i, (rgb_color_t) {0, 0, 0});
+            body_set_centroid(body, (vector_t) {(i * 37) % 100, (i * 61) % 100});
+            for (size_t j = 0; j < i; j++) {
+                create_newtonian_gravity(scenes[s], 10, body, scene_get_body(scenes[s], j));
+            }
+            list_t *bodies = list_init(1, NULL);
+            list_add(bodies, body);
+            scene_add_bodies_force_creator(scenes[s], push_back, body, bodies, NULL);
+            if (i > 0) {
+                create_spring(scenes[s], 0.1, body, scene_get_body(scenes[s], 0));
+            }
+            scene_add_body(scenes[s], body);
+        }
+    }
+    for (int tick = 0; tick < 100; tick++) {
+        scene_tick(scenes[0], 1e-2);
+        scene_tick(scenes[1], 1e-2);
+    }
+    for (size_t i = 0; i < N; i++) {
+        vector_t serial = body_get_centroid(scene_get_body(scenes[0], i));
+        vector_t parallel = body_get_centroid(scene_get_body(scenes[1], i));
+        assert(within(1e-9, serial.x, parallel.x));
+        assert(within(1e-9, serial.y, parallel.y));
+    }
+    scene_free(scenes[0]);
+    scene_free(scenes[1]);
+}
+
+// Tests that detecting collisions in parallel dispatches the same handlers
+void test_parallel_collisions() {
+    const size_t N = 20;
+    scene_t *scenes[2] = {scene_init(), scene_init()};
+    scene_set_threads(scenes[1], 4);
+    for (size_t s = 0; s < 2; s++) {
+        for (size_t i = 0; i < N; i++) {
+            body_t *body = body_init(make_shape(), 1 + i, (rgb_color_t) {0, 0, 0});
+            body_set_centroid(body, (vector_t) {(i % 5) * 3, (i / 5) * 3});
+            body_set_velocity(body, (vector_t) {(i * 7) % 5 - 2.0, (i * 3) % 5 - 2.0});
+            for (size_t j = 0; j < i; j++) {
+                create_physics_collision(scenes[s], 0.9, body, scene_get_body(scenes[s], j));
+            }
+            scene_add_body(scenes[s], body);
+        }
+    }
+    for (int tick = 0; tick < 200; tick++) {
+        scene_tick(scenes[0], 1e-2);
+        scene_tick(scenes[1], 1e-2);
+    }
+    for (size_t i = 0; i < N; i++) {
+        assert(vec_equal(body_get_velocity(scene_get_body(scenes[0], i)),
+                         body_get_velocity(scene_get_body(scenes[1], i))));
+        assert(vec_equal(body_get_centroid(scene_get_body(scenes[0], i)),
+                         body_get_centroid(scene_get_body(scenes[1], i))));
+    }
+    scene_free(scenes[0]);
+    scene_free(scenes[1]);
+}
+// Records where a bullet was when it hit something
+void record_hit(body_t *bullet, body_t *wall, vector_t axis, void *aux) {
+    *(vector_t *) aux = body_get_centroid(bullet);
+}
+
+// Tests that bullets hit thin walls they move all the way through in one tick
+void test_bullet_collisions() {
+    for (int bullet = 0; bullet <= 1; bullet++) {
+        scene_t *scene = scene_init();
+        body_t *wall = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+        scene_add_body(scene, wall);
+        body_t *ball = body_init_circle((vector_t) {-5, 0}, 0.25, 1, (rgb_color_t) {0, 0, 0}, NULL, NULL);
+        body_set_velocity(ball, (vector_t) {100, 0});
+        body_set_bullet(ball, bullet);
+        scene_add_body(scene, ball);
+        vector_t hit = {INFINITY, INFINITY};
+        create_collision(scene, ball, wall, record_hit, &hit, NULL);
+
+        for (int i = 0; i < 3; i++) {
+            scene_tick(scene, 0.1);
+        }
+        if (bullet) {
+            // The handler sees the ball where it first touched the wall
+            assert(isclose(hit.x, -1.25) && isclose(hit.y, 0));
+        }
+        else {
+            assert(hit.x == INFINITY);
+        }
+        scene_free(scene);
+    }
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -166,6 +339,11 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_energy_conservation)
     DO_TEST(test_collisions)
     DO_TEST(test_forces_removed)
+    DO_TEST(test_nbody_gravity)
+    DO_TEST(test_parallel_forces)
+    DO_TEST(test_parallel_mixed_forces)
+    DO_TEST(test_parallel_collisions)
+    DO_TEST(test_bullet_collisions)
 
     puts("forces_test PASS");
 }
@@ -0,0 +1,85 @@
+#include "frame_timer.h"
+#include "test_util.h"
+#include <assert.h>
+#include <string.h>
+
+// Spins until the given number of seconds have passed
+void wait_for(double seconds) {
+    double start = frame_timer_now();
+    while (frame_timer_now() - start < seconds);
+}
+
+void test_now_is_monotonic() {
+    double last = frame_timer_now();
+    for (size_t i = 0; i < 100000; i++) {
+        double now = frame_timer_now();
+        assert(now >= last);
+        last = now;
+    }
+    // Waiting counts, even though it is not CPU time of this process
+    double start = frame_timer_now();
+    wait_for(0.01);
+    assert(frame_timer_now() - start >= 0.01);
+}
+
+void test_frames() {
+    frame_timer_t *timer = frame_timer_init();
+    assert(frame_timer_tick(timer) == 0);
+    assert(frame_timer_get_fps(timer) == 0);
+    wait_for(0.01);
+    double dt = frame_timer_tick(timer);
+    assert(dt >= 0.01);
+    assert(frame_timer_get_dt(timer) == dt);
+    // The first frame sets the rate, and later frames only nudge it
+    assert(isclose(frame_timer_get_fps(timer), 1 / dt));
+    double fps = frame_timer_get_fps(timer);
+    frame_timer_tick(timer);
+    assert(frame_timer_get_fps(timer) > fps);
+    assert(frame_timer_get_fps(timer) < 1 / frame_timer_get_dt(timer));
+    frame_timer_free(timer);
+}
+
+void test_phases() {
+    frame_timer_t *timer = frame_timer_init();
+    size_t physics = frame_timer_add_phase(timer, "physics");
+    size_t render = frame_timer_add_phase(timer, "render");
+    for (size_t i = 0; i < 10; i++) {
+        frame_timer_add_phase(timer, "extra");
+    }
+    assert(frame_timer_num_phases(timer) == 12);
+    assert(strcmp(frame_timer_get_phase_name(timer, render), "render") == 0);
+
+    frame_timer_tick(timer);
+    // A phase run twice in a frame counts both runs
+    for (size_t i = 0; i < 2; i++) {
+        frame_timer_start_phase(timer, physics);
+        wait_for(0.005);
+        frame_timer_stop_phase(timer, physics);
+    }
+    frame_timer_start_phase(timer, render);
+    frame_timer_stop_phase(timer, render);
+    // Phase times only update when the frame ends
+    assert(frame_timer_get_phase_time(timer, physics) == 0);
+    frame_timer_tick(timer);
+    double physics_time = frame_timer_get_phase_time(timer, physics);
+    assert(physics_time >= 0.01);
+    assert(physics_time <= frame_timer_get_dt(timer));
+    assert(frame_timer_get_phase_time(timer, render) < physics_time);
+    frame_timer_free(timer);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_now_is_monotonic)
+    DO_TEST(test_frames)
+    DO_TEST(test_phases)
+
+    puts("frame_timer_test PASS");
+}
@@ -1,3 +1,37 @@
+#include "image.h"
+#include "test_util.h"
+#include <assert.h>
+
+void test_shared_assets() {
+    assert(image_num_assets() == 0);
+    image_t *first = image_init("images/floor.png", (vector_t) {10, 20}, 0);
+    image_t *second = image_init("images/floor.png", (vector_t) {30, 40}, 90);
+    image_t *other = image_init("images/lava.png", (vector_t) {10, 20}, 0);
+    assert(image_num_assets() == 2);
+    // Each image keeps its own dimensions and rotation over the shared file
+    assert(image_get_surface(first) == image_get_surface(second));
+    assert(image_get_surface(first) != image_get_surface(other));
+    assert(vec_equal(image_get_dimensions(second), (vector_t) {30, 40}));
+    assert(image_get_rotation(second) == 90);
+
+    image_free(first);
+    assert(image_num_assets() == 2);
+    image_free(second);
+    assert(image_num_assets() == 1);
+    image_free(other);
+    assert(image_num_assets() == 0);
+}
+
 int main(int argc, char *argv[]) {
-    
-}
\ No newline at end of file
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_shared_assets)
+
+    puts("image_test PASS");
+}
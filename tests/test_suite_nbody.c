@@ -0,0 +1,106 @@
+#include "nbody.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+void test_pairwise_two_bodies() {
+    double x[] = {0, 10}, y[] = {0, 0}, mass[] = {2, 3};
+    double fx[] = {0, 0}, fy[] = {0, 0};
+    nbody_pairwise_forces(2, x, y, mass, 5, 1, fx, fy);
+    // G m1 m2 / d^2 = 5 * 2 * 3 / 100, pulling the bodies together
+    assert(isclose(fx[0], 0.3));
+    assert(isclose(fx[1], -0.3));
+    assert(fy[0] == 0 && fy[1] == 0);
+
+    // Bodies closer than the minimum distance do not attract
+    x[1] = 0.5;
+    fx[0] = fx[1] = 0;
+    nbody_pairwise_forces(2, x, y, mass, 5, 1, fx, fy);
+    assert(fx[0] == 0 && fx[1] == 0);
+}
+
+void test_pairwise_momentum() {
+    const size_t N = 50;
+    double *x = malloc(N * sizeof(double)), *y = malloc(N * sizeof(double));
+    double *mass = malloc(N * sizeof(double));
+    double *fx = calloc(N, sizeof(double)), *fy = calloc(N, sizeof(double));
+    for (size_t i = 0; i < N; i++) {
+        x[i] = rand() % 1000;
+        y[i] = rand() % 1000;
+        mass[i] = 1 + rand() % 10;
+    }
+    nbody_pairwise_forces(N, x, y, mass, 1, 1, fx, fy);
+    // Equal and opposite forces cancel out
+    double total_x = 0, total_y = 0;
+    for (size_t i = 0; i < N; i++) {
+        total_x += fx[i];
+        total_y += fy[i];
+    }
+    assert(within(1e-9, total_x, 0));
+    assert(within(1e-9, total_y, 0));
+    free(x);
+    free(y);
+    free(mass);
+    free(fx);
+    free(fy);
+}
+
+void test_barnes_hut_matches_pairwise() {
+    const size_t N = 500;
+    double *x = malloc(N * sizeof(double)), *y = malloc(N * sizeof(double));
+    double *mass = malloc(N * sizeof(double));
+    double *exact_x = calloc(N, sizeof(double)), *exact_y = calloc(N, sizeof(double));
+    double *tree_x = calloc(N, sizeof(double)), *tree_y = calloc(N, sizeof(double));
+    for (size_t i = 0; i < N; i++) {
+        x[i] = rand() % 1000;
+        y[i] = rand() % 1000;
+        mass[i] = 1 + rand() % 10;
+    }
+    // Two coincident points share a leaf at the maximum depth
+    x[1] = x[0];
+    y[1] = y[0];
+    nbody_pairwise_forces(N, x, y, mass, 1, 1, exact_x, exact_y);
+
+    // An opening angle of 0 never approximates, so it is exact
+    nbody_barnes_hut_forces(N, x, y, mass, 1, 1, 0, tree_x, tree_y);
+    for (size_t i = 0; i < N; i++) {
+        assert(within(1e-9, tree_x[i], exact_x[i]));
+        assert(within(1e-9, tree_y[i], exact_y[i]));
+    }
+
+    // The approximation stays close to the exact total force
+    double error = 0, total = 0;
+    for (size_t i = 0; i < N; i++) {
+        tree_x[i] = tree_y[i] = 0;
+    }
+    nbody_barnes_hut_forces(N, x, y, mass, 1, 1, 0.5, tree_x, tree_y);
+    for (size_t i = 0; i < N; i++) {
+        error += hypot(tree_x[i] - exact_x[i], tree_y[i] - exact_y[i]);
+        total += hypot(exact_x[i], exact_y[i]);
+    }
+    assert(error < 0.01 * total);
+    free(x);
+    free(y);
+    free(mass);
+    free(exact_x);
+    free(exact_y);
+    free(tree_x);
+    free(tree_y);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_pairwise_two_bodies)
+    DO_TEST(test_pairwise_momentum)
+    DO_TEST(test_barnes_hut_matches_pairwise)
+
+    puts("nbody_test PASS");
+}
@@ -213,6 +213,87 @@ void test_weird_rotate() {
     list_free(w);
 }
 
+void test_points_match_list() {
+    list_t *w = make_weird();
+    size_t size = list_size(w);
+    vector_t points[5];
+    for (size_t i = 0; i < size; i++) {
+        points[i] = *(vector_t *) list_get(w, i);
+    }
+    assert(polygon_points_area(points, size) == polygon_area(w));
+    assert(vec_equal(polygon_points_centroid(points, size), polygon_centroid(w)));
+
+    polygon_translate(w, (vector_t) {2, 3});
+    polygon_points_translate(points, size, (vector_t) {2, 3});
+    polygon_rotate(w, 0.7, (vector_t) {0, 2});
+    polygon_points_rotate(points, size, 0.7, (vector_t) {0, 2});
+    for (size_t i = 0; i < size; i++) {
+        assert(vec_isclose(points[i], *(vector_t *) list_get(w, i)));
+    }
+
+    double min, max;
+    polygon_points_project(points, size, (vector_t) {1, 0}, &min, &max);
+    bounding_box_t box = polygon_points_bounding_box(points, size);
+    assert(min == box.min.x && max == box.max.x);
+
+    list_free(w);
+}
+
+void test_kernels_match() {
+    const size_t MAX_SIZE = 61;
+    vector_t local[MAX_SIZE], expected[MAX_SIZE], actual[MAX_SIZE];
+    for (size_t i = 0; i < MAX_SIZE; i++) {
+        local[i] = (vector_t) {rand() % 200 - 100 + 0.25, rand() % 200 - 100 - 0.125};
+    }
+    vector_t axis = vec_rotate((vector_t) {1, 0}, 0.3);
+    polygon_kernels_t best = polygon_get_kernels();
+    // Every size exercises the vector loops and their scalar tails
+    for (polygon_kernels_t kernels = POLYGON_KERNELS_SSE2; kernels <= best; kernels++) {
+        for (size_t size = 0; size <= MAX_SIZE; size++) {
+            double expected_min, expected_max, actual_min, actual_max;
+            polygon_set_kernels(POLYGON_KERNELS_SCALAR);
+            polygon_points_transform(local, expected, size, (vector_t) {3, -4}, 0.7);
+            polygon_points_project(expected, size, axis, &expected_min, &expected_max);
+            assert(polygon_set_kernels(kernels) == kernels);
+            polygon_points_transform(local, actual, size, (vector_t) {3, -4}, 0.7);
+            polygon_points_project(actual, size, axis, &actual_min, &actual_max);
+            for (size_t i = 0; i < size; i++) {
+                assert(vec_equal(expected[i], actual[i]));
+            }
+            assert(expected_min == actual_min && expected_max == actual_max);
+
+            polygon_points_transform(local, actual, size, (vector_t) {3, -4}, 0);
+            for (size_t i = 0; i < size; i++) {
+                assert(vec_equal(actual[i], vec_add(local[i], (vector_t) {3, -4})));
+            }
+        }
+    }
+    polygon_set_kernels(best);
+}
+
+void test_project_far_away() {
+    const size_t MAX_SIZE = 9;
+    vector_t far[MAX_SIZE], near[MAX_SIZE];
+    for (size_t i = 0; i < MAX_SIZE; i++) {
+        // Entirely beyond 1e7 on one side or the other
+        far[i] = (vector_t) {3e7 + i, 5};
+        near[i] = (vector_t) {-2e8 - i, 5};
+    }
+    polygon_kernels_t best = polygon_get_kernels();
+    for (polygon_kernels_t kernels = POLYGON_KERNELS_SCALAR; kernels <= best; kernels++) {
+        assert(polygon_set_kernels(kernels) == kernels);
+        double min, max;
+        polygon_points_project(far, 0, (vector_t) {1, 0}, &min, &max);
+        assert(min == INFINITY && max == -INFINITY);
+        for (size_t size = 1; size <= MAX_SIZE; size++) {
+            polygon_points_project(far, size, (vector_t) {1, 0}, &min, &max);
+            assert(min == 3e7 && max == 3e7 + size - 1);
+            polygon_points_project(near, size, (vector_t) {1, 0}, &min, &max);
+            assert(min == -2e8 - (size - 1) && max == -2e8);
+        }
+    }
+    polygon_set_kernels(best);
+}
 
 int main(int argc, char *argv[]) {
     // Run all tests? True if there are no command-line arguments
@@ -231,6 +312,9 @@ int main(int argc, char *argv[]) {
     // DO_TEST(test_triangle_rotate)
     // DO_TEST(test_circ_area_centroid)
     // DO_TEST(test_weird_area_centroid)
+    DO_TEST(test_points_match_list)
+    DO_TEST(test_kernels_match)
+    DO_TEST(test_project_far_away)
 
 
     puts("polygon_test PASS");
@@ -230,6 +230,356 @@ void test_reaping() {
     scene_free(scene);
 }
 
+// A collision force creator that counts how many times it is invoked
+void count_collision_checks(void *aux) {
+    (*(int *) aux)++;
+}
+
+void test_broad_phase_culling() {
+    scene_t *scene = scene_init();
+    body_t *body1 = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_t *body2 = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(body2, (vector_t) {1000, 0});
+    scene_add_body(scene, body1);
+    scene_add_body(scene, body2);
+
+    int *count = malloc(sizeof(*count));
+    *count = 0;
+    list_t *bodies = list_init(2, NULL);
+    list_add(bodies, body1);
+    list_add(bodies, body2);
+    scene_add_collision_force_creator(scene, NULL, count_collision_checks, count, bodies, free);
+
+    // Always checked on the first tick, then culled while far apart
+    scene_tick(scene, 1);
+    assert(*count == 1);
+    scene_tick(scene, 1);
+    scene_tick(scene, 1);
+    assert(*count == 1);
+
+    // Checked every tick while the bounding boxes overlap
+    body_set_centroid(body2, (vector_t) {1, 1});
+    scene_tick(scene, 1);
+    scene_tick(scene, 1);
+    assert(*count == 3);
+
+    // Checked once more after separating, then culled again
+    body_set_centroid(body2, (vector_t) {0, 500});
+    scene_tick(scene, 1);
+    assert(*count == 4);
+    scene_tick(scene, 1);
+    assert(*count == 4);
+
+    scene_free(scene);
+}
+
+void test_static_broad_phase() {
+    scene_t *scene = scene_init();
+    body_t *ball = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_t *wall1 = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    body_t *wall2 = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(ball, (vector_t) {1000, 0});
+    body_set_centroid(wall2, (vector_t) {1, 1});
+    scene_add_body(scene, ball);
+    scene_add_body(scene, wall1);
+    scene_add_body(scene, wall2);
+
+    int *wall_checks = malloc(sizeof(*wall_checks));
+    int *ball_checks = malloc(sizeof(*ball_checks));
+    *wall_checks = 0;
+    *ball_checks = 0;
+    list_t *walls = list_init(2, NULL);
+    list_add(walls, wall1);
+    list_add(walls, wall2);
+    scene_add_collision_force_creator(scene, NULL, count_collision_checks, wall_checks, walls, free);
+    list_t *bodies = list_init(2, NULL);
+    list_add(bodies, ball);
+    list_add(bodies, wall1);
+    scene_add_collision_force_creator(scene, NULL, count_collision_checks, ball_checks, bodies, free);
+
+    // Overlapping walls are never paired once neither is moving
+    for (size_t i = 0; i < 5; i++) {
+        scene_tick(scene, 1);
+    }
+    assert(body_get_motion(wall1) == BODY_STATIC);
+    assert(*wall_checks == 2);
+    assert(*ball_checks == 1);
+
+    // A moving body is still paired with the static walls it reaches
+    body_set_centroid(ball, (vector_t) {1, 0});
+    scene_tick(scene, 1);
+    assert(*ball_checks == 2);
+
+    // and a static wall moved onto a resting body is found there too
+    body_set_centroid(ball, (vector_t) {500, 0});
+    body_set_velocity(ball, VEC_ZERO);
+    scene_tick(scene, 1);
+    scene_tick(scene, 1);
+    assert(*ball_checks == 3);
+    body_set_centroid(wall1, (vector_t) {500, 1});
+    assert(body_get_motion(wall1) == BODY_DYNAMIC);
+    scene_tick(scene, 1);
+    assert(*ball_checks == 4);
+    assert(body_get_motion(wall1) == BODY_STATIC);
+
+    // A static body only joins the broad phase once it has a collision force
+    body_t *wall3 = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    body_set_centroid(wall3, (vector_t) {500, -1});
+    scene_add_body(scene, wall3);
+    scene_tick(scene, 1);
+    assert(body_get_motion(wall3) == BODY_STATIC);
+    int *wall3_checks = malloc(sizeof(*wall3_checks));
+    *wall3_checks = 0;
+    list_t *resting = list_init(2, NULL);
+    list_add(resting, ball);
+    list_add(resting, wall3);
+    scene_add_collision_force_creator(scene, NULL, count_collision_checks, wall3_checks, resting, free);
+    for (size_t i = 0; i < 3; i++) {
+        scene_tick(scene, 1);
+    }
+    assert(*wall3_checks == 3);
+    scene_free(scene);
+}
+
+void test_static_and_sleeping_bodies() {
+    scene_t *scene = scene_init();
+    body_t *wall = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+    body_t *ball = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, wall);
+    scene_add_body(scene, ball);
+    body_set_velocity(ball, (vector_t) {1, 0});
+    assert(scene_dynamic_bodies(scene) == 2);
+
+    // The wall cannot move, so it stops being ticked after its first tick
+    scene_tick(scene, 1);
+    assert(body_get_motion(wall) == BODY_STATIC);
+    assert(scene_dynamic_bodies(scene) == 1);
+    body_add_force(wall, (vector_t) {5, 5});
+    assert(body_get_motion(wall) == BODY_STATIC);
+
+    // The ball falls asleep after resting for long enough
+    body_set_velocity(ball, VEC_ZERO);
+    for (size_t i = 0; i < 100; i++) {
+        scene_tick(scene, 0.01);
+    }
+    assert(body_get_motion(ball) == BODY_SLEEPING);
+    assert(scene_dynamic_bodies(scene) == 0);
+
+    // and a force wakes it up in time to be integrated this tick
+    vector_t before = body_get_centroid(ball);
+    body_add_force(ball, (vector_t) {100, 0});
+    assert(body_get_motion(ball) == BODY_DYNAMIC);
+    scene_tick(scene, 1);
+    assert(scene_dynamic_bodies(scene) == 1);
+    assert(body_get_centroid(ball).x > before.x);
+
+    // Removed bodies are dropped from the dynamic set before being freed
+    body_remove(ball);
+    scene_tick(scene, 1);
+    assert(scene_bodies(scene) == 1);
+    assert(scene_dynamic_bodies(scene) == 0);
+    scene_free(scene);
+}
+
+void test_tag_index() {
+    scene_t *scene = scene_init();
+    assert(scene_get_tagged(scene, 'W') == NULL);
+    body_t *untagged = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, untagged);
+    body_t *walls[3];
+    for (size_t i = 0; i < 3; i++) {
+        walls[i] = body_init(make_shape(), INFINITY, (rgb_color_t) {0, 0, 0});
+        body_set_tag(walls[i], 'W');
+        scene_add_body(scene, walls[i]);
+    }
+    body_t *player = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_tag(player, 'P');
+    scene_add_body(scene, player);
+
+    assert(body_get_tag(untagged) == BODY_NO_TAG);
+    assert(scene_get_tagged(scene, 'P') == player);
+    assert(scene_get_tagged(scene, 'W') == walls[2]);
+    assert(list_size(scene_get_tagged_bodies(scene, 'W')) == 3);
+
+    // Removed bodies stay indexed until the scene frees them
+    body_remove(walls[2]);
+    body_remove(player);
+    assert(scene_get_tagged(scene, 'P') == player);
+    scene_tick(scene, 1);
+    assert(scene_get_tagged(scene, 'P') == NULL);
+    assert(scene_get_tagged(scene, 'W') == walls[1]);
+    assert(list_size(scene_get_tagged_bodies(scene, 'W')) == 2);
+    scene_free(scene);
+}
+
+void test_bulk_removal() {
+    const size_t N = 1000;
+    scene_t *scene = scene_init();
+    for (size_t i = 0; i < N; i++) {
+        body_t *body = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+        body_set_tag(body, i % 2 == 0 ? 'A' : 'B');
+        scene_add_body(scene, body);
+    }
+    int *count = malloc(sizeof(*count));
+    *count = 0;
+    list_t *bodies = list_init(1, NULL);
+    list_add(bodies, scene_get_body(scene, 1));
+    scene_add_bodies_force_creator(scene, count_collision_checks, count, bodies, NULL);
+    scene_add_force_creator(scene, count_collision_checks, count, NULL);
+
+    // Remove every even body in one tick; the survivors keep their order
+    for (size_t i = 0; i < N; i += 2) {
+        body_remove(scene_get_body(scene, i));
+    }
+    scene_tick(scene, 1);
+    assert(*count == 2);
+    assert(scene_bodies(scene) == N / 2);
+    assert(scene_get_tagged(scene, 'A') == NULL);
+    assert(list_size(scene_get_tagged_bodies(scene, 'B')) == N / 2);
+    for (size_t i = 0; i < N / 2; i++) {
+        assert(scene_get_body(scene, i) == list_get(scene_get_tagged_bodies(scene, 'B'), i));
+    }
+
+    // A removed force is not called again and is freed at the end of the tick
+    list_t *forces = scene_get_forces(scene);
+    assert(list_size(forces) == 2);
+    scene_remove_force(scene, list_get(forces, 1));
+    scene_tick(scene, 1);
+    assert(*count == 3);
+    assert(list_size(forces) == 1);
+
+    // Removing a body frees the forces acting on it
+    body_remove(scene_get_body(scene, 0));
+    scene_tick(scene, 1);
+    assert(list_size(forces) == 0);
+    assert(scene_bodies(scene) == N / 2 - 1);
+    free(count);
+    scene_free(scene);
+}
+
+void add_pair_force(scene_t *scene, body_t *body1, body_t *body2, int *count) {
+    list_t *bodies = list_init(2, NULL);
+    list_add(bodies, body1);
+    list_add(bodies, body2);
+    scene_add_bodies_force_creator(scene, count_collision_checks, count, bodies, NULL);
+}
+
+void test_force_reverse_index() {
+    int count = 0;
+    scene_t *scene = scene_init();
+    body_t *a = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_t *b = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_t *c = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    scene_add_body(scene, a);
+    scene_add_body(scene, b);
+    scene_add_body(scene, c);
+    add_pair_force(scene, a, b, &count);
+    add_pair_force(scene, b, c, &count);
+    add_pair_force(scene, a, c, &count);
+    assert(list_size(body_get_force_creators(a)) == 2);
+    assert(list_size(body_get_force_creators(b)) == 2);
+
+    // Removing a drops its forces from the bodies they also acted on
+    body_remove(a);
+    scene_tick(scene, 1);
+    assert(count == 3);
+    assert(list_size(scene_get_forces(scene)) == 1);
+    assert(list_size(body_get_force_creators(b)) == 1);
+    assert(list_size(body_get_force_creators(c)) == 1);
+
+    // Removing a force directly also drops it from its bodies
+    scene_remove_force(scene, list_get(scene_get_forces(scene), 0));
+    assert(list_size(body_get_force_creators(b)) == 0);
+    assert(list_size(body_get_force_creators(c)) == 0);
+    scene_tick(scene, 1);
+    assert(list_size(scene_get_forces(scene)) == 0);
+    scene_free(scene);
+}
+
+void test_parallel_integration() {
+    const size_t N = 1500;
+    scene_t *scene = scene_init();
+    scene_set_threads(scene, 4);
+    body_t **copies = malloc(sizeof(body_t *) * N);
+    for (size_t i = 0; i < N; i++) {
+        for (size_t copy = 0; copy < 2; copy++) {
+            body_t *body = body_init(make_shape(), 1 + i % 7, (rgb_color_t) {0, 0, 0});
+            body_set_centroid(body, (vector_t) {i, -(double) i});
+            body_set_velocity(body, (vector_t) {i % 3 - 1.0, i % 5 - 2.0});
+            body_set_passive_rotation(body, i % 2 * 0.5);
+            if (copy == 0) {
+                scene_add_body(scene, body);
+            }
+            else {
+                copies[i] = body;
+            }
+        }
+    }
+    // The scene integrates in blocks on several threads, the copies one by one
+    for (int tick = 0; tick < 10; tick++) {
+        for (size_t i = 0; i < N; i++) {
+            vector_t force = {tick - 5.0, i % 11 * 0.1};
+            body_add_force(scene_get_body(scene, i), force);
+            body_add_force(copies[i], force);
+            body_add_impulse(scene_get_body(scene, i), vec_negate(force));
+            body_add_impulse(copies[i], vec_negate(force));
+            body_tick(copies[i], 1e-2);
+        }
+        scene_tick(scene, 1e-2);
+    }
+    for (size_t i = 0; i < N; i++) {
+        body_t *body = scene_get_body(scene, i);
+        assert(vec_equal(body_get_centroid(body), body_get_centroid(copies[i])));
+        assert(vec_equal(body_get_velocity(body), body_get_velocity(copies[i])));
+        bounding_box_t box = body_get_bounding_box(body);
+        bounding_box_t copy_box = body_get_bounding_box(copies[i]);
+        assert(vec_equal(box.min, copy_box.min) && vec_equal(box.max, copy_box.max));
+        body_free(copies[i]);
+    }
+    free(copies);
+    scene_free(scene);
+}
+bool is_not_body(body_t *body, void *aux) {
+    return body != aux;
+}
+
+void test_raycast() {
+    scene_t *scene = scene_init();
+    // A row of squares along the x-axis, 1000 apart so they fall in different cells
+    body_t *bodies[5];
+    for (size_t i = 0; i < 5; i++) {
+        bodies[i] = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+        body_set_centroid(bodies[i], (vector_t) {1000.0 * i, 0});
+        scene_add_body(scene, bodies[i]);
+    }
+    ray_hit_t hit;
+    // The ray starts inside bodies[0], so it passes out of it
+    assert(scene_raycast(scene, VEC_ZERO, (vector_t) {2, 0}, 5000, NULL, NULL, &hit) == bodies[1]);
+    assert(isclose(hit.distance, 999));
+    assert(vec_isclose(hit.normal, (vector_t) {-1, 0}));
+    assert(scene_raycast(scene, (vector_t) {4500, 0}, (vector_t) {-1, 0}, 5000, NULL, NULL, &hit)
+           == bodies[4]);
+    assert(vec_isclose(hit.point, (vector_t) {4001, 0}));
+    assert(scene_raycast(scene, (vector_t) {4500, 0}, (vector_t) {-1, 0}, 100, NULL, NULL, NULL) == NULL);
+    assert(scene_raycast(scene, (vector_t) {0, 5}, (vector_t) {1, 0}, 5000, NULL, NULL, NULL) == NULL);
+
+    // Filtered and removed bodies are skipped
+    assert(scene_raycast(scene, VEC_ZERO, (vector_t) {1, 0}, 5000, is_not_body, bodies[1], NULL)
+           == bodies[2]);
+    scene_remove_body(scene, 2);
+    assert(scene_raycast(scene, VEC_ZERO, (vector_t) {1, 0}, 5000, is_not_body, bodies[1], NULL)
+           == bodies[3]);
+
+    // Bodies are found where they are after a tick
+    scene_tick(scene, 1);
+    body_set_centroid(bodies[1], (vector_t) {0, 500});
+    body_set_velocity(bodies[1], (vector_t) {0, -250});
+    scene_tick(scene, 1);
+    assert(scene_raycast(scene, (vector_t) {0, 10}, (vector_t) {0, 1}, 1000, NULL, NULL, &hit) == bodies[1]);
+    assert(isclose(hit.distance, 239));
+    scene_free(scene);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -244,6 +594,14 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_force_creator)
     DO_TEST(test_force_creator_aux)
     DO_TEST(test_reaping)
+    DO_TEST(test_broad_phase_culling)
+    DO_TEST(test_static_broad_phase)
+    DO_TEST(test_static_and_sleeping_bodies)
+    DO_TEST(test_tag_index)
+    DO_TEST(test_bulk_removal)
+    DO_TEST(test_force_reverse_index)
+    DO_TEST(test_parallel_integration)
+    DO_TEST(test_raycast)
 
     puts("scene_test PASS");
 }
@@ -0,0 +1,176 @@
+#include "spatial_hash.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+bounding_box_t make_box(double min_x, double min_y, double max_x, double max_y) {
+    return (bounding_box_t) {{min_x, min_y}, {max_x, max_y}};
+}
+
+void test_empty_hash() {
+    spatial_hash_t *hash = spatial_hash_init(10);
+    assert(spatial_hash_size(hash) == 0);
+    assert(spatial_hash_find_pairs(hash) == 0);
+    int a, b;
+    assert(!spatial_hash_has_pair(hash, &a, &b));
+    spatial_hash_free(hash);
+}
+
+void test_pairs() {
+    spatial_hash_t *hash = spatial_hash_init(10);
+    int a, b, c, d;
+    // a and b overlap across several shared cells, c is far away,
+    // and d only touches b along an edge
+    spatial_hash_insert(hash, &a, make_box(0, 0, 25, 25));
+    spatial_hash_insert(hash, &b, make_box(15, 15, 40, 40));
+    spatial_hash_insert(hash, &c, make_box(500, 500, 510, 510));
+    spatial_hash_insert(hash, &d, make_box(40, 0, 50, 10));
+    assert(spatial_hash_size(hash) == 4);
+    assert(spatial_hash_find_pairs(hash) == 1);
+    assert(spatial_hash_has_pair(hash, &a, &b));
+    assert(spatial_hash_has_pair(hash, &b, &a));
+    assert(!spatial_hash_has_pair(hash, &a, &c));
+    assert(!spatial_hash_has_pair(hash, &b, &d));
+
+    spatial_hash_clear(hash);
+    assert(spatial_hash_size(hash) == 0);
+    assert(!spatial_hash_has_pair(hash, &a, &b));
+    spatial_hash_free(hash);
+}
+
+void test_large_boxes() {
+    spatial_hash_t *hash = spatial_hash_init(1);
+    int wall, small, other;
+    // The wall covers far more cells than are stored per value
+    spatial_hash_insert(hash, &wall, make_box(-1000, -1000, 1000, 0));
+    spatial_hash_insert(hash, &small, make_box(5, -2, 6, 2));
+    spatial_hash_insert(hash, &other, make_box(5, 1, 6, 3));
+    assert(spatial_hash_find_pairs(hash) == 2);
+    assert(spatial_hash_has_pair(hash, &wall, &small));
+    assert(spatial_hash_has_pair(hash, &small, &other));
+    assert(!spatial_hash_has_pair(hash, &wall, &other));
+    spatial_hash_free(hash);
+}
+
+void test_query() {
+    spatial_hash_t *hash = spatial_hash_init(10);
+    int values[100];
+    for (int i = 0; i < 100; i++) {
+        double x = (i % 10) * 20, y = (i / 10) * 20;
+        spatial_hash_insert(hash, &values[i], make_box(x, y, x + 15, y + 15));
+    }
+    list_t *results = list_init(4, NULL);
+    assert(spatial_hash_query(hash, make_box(18, 18, 42, 22), results) == 2);
+    assert(list_index_of(results, &values[11]) != -1);
+    assert(list_index_of(results, &values[12]) != -1);
+    list_free(results);
+
+    results = list_init(4, NULL);
+    assert(spatial_hash_query(hash, make_box(-1000, -1000, 1000, 1000), results) == 100);
+    list_free(results);
+    spatial_hash_free(hash);
+}
+
+void test_query_segment() {
+    spatial_hash_t *hash = spatial_hash_init(10);
+    int values[100];
+    for (int i = 0; i < 100; i++) {
+        double x = (i % 10) * 20, y = (i / 10) * 20;
+        spatial_hash_insert(hash, &values[i], make_box(x, y, x + 15, y + 15));
+    }
+    // A diagonal only passes through the boxes along it
+    list_t *results = list_init(4, NULL);
+    assert(spatial_hash_query_segment(hash, (vector_t) {1, 1}, (vector_t) {99, 99}, results) == 5);
+    for (int i = 0; i < 5; i++) {
+        assert(list_index_of(results, &values[11 * i]) != -1);
+    }
+    list_free(results);
+
+    // Segments in every direction match a brute force check of every box
+    for (int angle = 0; angle < 64; angle++) {
+        vector_t start = {95, 93};
+        vector_t end = vec_add(start, vec_rotate((vector_t) {150, 0}, 2 * M_PI * angle / 64));
+        results = list_init(4, NULL);
+        spatial_hash_query_segment(hash, start, end, results);
+        for (int i = 0; i < 100; i++) {
+            double x = (i % 10) * 20, y = (i / 10) * 20;
+            bool crossed = false;
+            for (int step = 0; step <= 10000 && !crossed; step++) {
+                vector_t point = vec_add(start, vec_multiply(step / 10000.0, vec_subtract(end, start)));
+                crossed = x < point.x && point.x < x + 15 && y < point.y && point.y < y + 15;
+            }
+            if (crossed) {
+                assert(list_index_of(results, &values[i]) != -1);
+            }
+        }
+        list_free(results);
+    }
+    spatial_hash_free(hash);
+}
+
+void test_many_pairs() {
+    const int N = 200;
+    spatial_hash_t *hash = spatial_hash_init(5);
+    int *values = malloc(sizeof(int) * N);
+    // Overlapping chain: each box overlaps only its neighbors
+    for (int i = 0; i < N; i++) {
+        spatial_hash_insert(hash, &values[i], make_box(i * 3, 0, i * 3 + 4, 4));
+    }
+    assert(spatial_hash_find_pairs(hash) == (size_t) N - 1);
+    for (int i = 0; i + 1 < N; i++) {
+        assert(spatial_hash_has_pair(hash, &values[i], &values[i + 1]));
+        if (i + 2 < N) {
+            assert(!spatial_hash_has_pair(hash, &values[i], &values[i + 2]));
+        }
+    }
+    free(values);
+    spatial_hash_free(hash);
+}
+
+void test_pairs_with() {
+    spatial_hash_t *moving = spatial_hash_init(10);
+    spatial_hash_t *still = spatial_hash_init(10);
+    int ball1, ball2, wall1, wall2, floor;
+    spatial_hash_insert(moving, &ball1, make_box(0, 0, 5, 5));
+    spatial_hash_insert(moving, &ball2, make_box(100, 100, 105, 105));
+    // The walls overlap each other, but neither is moving
+    spatial_hash_insert(still, &wall1, make_box(4, 4, 20, 20));
+    spatial_hash_insert(still, &wall2, make_box(10, 10, 30, 30));
+    spatial_hash_insert(still, &floor, make_box(-1000, -10, 1000, 1));
+    assert(spatial_hash_find_pairs(moving) == 0);
+    assert(spatial_hash_find_pairs_with(moving, still) == 2);
+    assert(spatial_hash_has_pair(moving, &ball1, &wall1));
+    assert(spatial_hash_has_pair(moving, &floor, &ball1));
+    assert(!spatial_hash_has_pair(moving, &wall1, &wall2));
+    assert(!spatial_hash_has_pair(moving, &ball2, &wall2));
+
+    // The other hash can be paired against again after the first is refilled
+    spatial_hash_clear(moving);
+    spatial_hash_insert(moving, &ball2, make_box(25, 25, 35, 35));
+    assert(spatial_hash_find_pairs_with(moving, still) == 1);
+    assert(spatial_hash_has_pair(moving, &ball2, &wall2));
+    assert(!spatial_hash_has_pair(moving, &ball1, &wall1));
+    spatial_hash_free(moving);
+    spatial_hash_free(still);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_empty_hash)
+    DO_TEST(test_pairs)
+    DO_TEST(test_large_boxes)
+    DO_TEST(test_query)
+    DO_TEST(test_query_segment)
+    DO_TEST(test_many_pairs)
+    DO_TEST(test_pairs_with)
+
+    puts("spatial_hash_test PASS");
+}
@@ -0,0 +1,78 @@
+#include "stepper.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+list_t *make_shape() {
+    list_t *shape = list_init(4, free);
+    vector_t corners[] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    for (size_t i = 0; i < 4; i++) {
+        vector_t *v = malloc(sizeof(*v));
+        *v = corners[i];
+        list_add(shape, v);
+    }
+    return shape;
+}
+
+void test_fixed_steps() {
+    scene_t *scene = scene_init();
+    body_t *body = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_velocity(body, (vector_t) {1, 0});
+    scene_add_body(scene, body);
+    stepper_t *stepper = stepper_init(0.25, 10);
+    assert(stepper_get_step(stepper) == 0.25);
+
+    // Not enough time for a step yet
+    assert(stepper_advance(stepper, scene, 0.125) == 0);
+    assert(isclose(stepper_get_alpha(stepper), 0.5));
+    assert(vec_equal(body_get_centroid(body), VEC_ZERO));
+    // The leftover time carries over to later calls
+    assert(stepper_advance(stepper, scene, 0.5) == 2);
+    assert(isclose(stepper_get_alpha(stepper), 0.5));
+    assert(vec_isclose(body_get_centroid(body), (vector_t) {0.5, 0}));
+    assert(vec_isclose(body_get_interpolated_centroid(body, stepper_get_alpha(stepper)),
+                       (vector_t) {0.375, 0}));
+
+    // Any split of the same time takes the same steps
+    for (size_t i = 0; i < 8; i++) {
+        stepper_advance(stepper, scene, 0.0625);
+    }
+    assert(vec_isclose(body_get_centroid(body), (vector_t) {1, 0}));
+    assert(isclose(stepper_get_alpha(stepper), 0.5));
+
+    stepper_free(stepper);
+    scene_free(scene);
+}
+
+void test_max_steps() {
+    scene_t *scene = scene_init();
+    body_t *body = body_init(make_shape(), 1, (rgb_color_t) {0, 0, 0});
+    body_set_velocity(body, (vector_t) {1, 0});
+    scene_add_body(scene, body);
+    stepper_t *stepper = stepper_init(0.25, 3);
+
+    // A long stall only runs the maximum number of steps, and the rest is dropped
+    assert(stepper_advance(stepper, scene, 10.1) == 3);
+    assert(vec_isclose(body_get_centroid(body), (vector_t) {0.75, 0}));
+    assert(stepper_get_alpha(stepper) < 1);
+    assert(stepper_advance(stepper, scene, 0) == 0);
+
+    stepper_free(stepper);
+    scene_free(scene);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_fixed_steps)
+    DO_TEST(test_max_steps)
+
+    puts("stepper_test PASS");
+}
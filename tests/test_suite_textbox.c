@@ -1,3 +1,58 @@
+#include "textbox.h"
+#include "test_util.h"
+#include <assert.h>
+#include <string.h>
+
+const SDL_Color TEXT_COLOR = {0, 200, 0};
+
+void test_shared_fonts() {
+    assert(textbox_num_fonts() == 0);
+    textbox_t *first = textbox_init(0, 0, 100, 20, "one", "fonts/karvwood.otf", 150, TEXT_COLOR);
+    textbox_t *second = textbox_init(0, 30, 100, 20, "two", "fonts/karvwood.otf", 150, TEXT_COLOR);
+    textbox_t *bigger = textbox_init(0, 60, 100, 20, "three", "fonts/karvwood.otf", 200, TEXT_COLOR);
+    // Fonts are shared by path and size
+    assert(textbox_num_fonts() == 2);
+    assert(textbox_get_font(first) == textbox_get_font(second));
+    assert(textbox_get_font(first) != textbox_get_font(bigger));
+
+    textbox_set_font(bigger, "fonts/karvwood.otf", 150);
+    assert(textbox_num_fonts() == 1);
+    assert(textbox_get_font(bigger) == textbox_get_font(first));
+
+    textbox_free(first);
+    textbox_free(second);
+    assert(textbox_num_fonts() == 1);
+    textbox_free(bigger);
+    assert(textbox_num_fonts() == 0);
+}
+
+void test_textbox_setters() {
+    char text[] = "Score: 1";
+    textbox_t *textbox = textbox_init(10, 20, 100, 20, text, "fonts/Skranji-Regular.ttf", 120, TEXT_COLOR);
+    // The textbox keeps its own copy of the text
+    strcpy(text, "Score: 2");
+    assert(strcmp(textbox_get_text(textbox), "Score: 1") == 0);
+    textbox_set_text(textbox, text);
+    assert(strcmp(textbox_get_text(textbox), "Score: 2") == 0);
+    textbox_set_color(textbox, (SDL_Color) {1, 2, 3});
+    SDL_Color color = textbox_get_color(textbox);
+    assert(color.r == 1 && color.g == 2 && color.b == 3);
+    assert(textbox_get_x(textbox) == 10 && textbox_get_y(textbox) == 20);
+    textbox_free(textbox);
+}
 
 int main(int argc, char *argv[]) {
-}
\ No newline at end of file
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    TTF_Init();
+    DO_TEST(test_shared_fonts)
+    DO_TEST(test_textbox_setters)
+
+    puts("textbox_test PASS");
+}
@@ -0,0 +1,48 @@
+#include "thread_pool.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdlib.h>
+
+void count_task(size_t index, void *aux) {
+    // Each task owns its own counter, so no locking is needed
+    ((int *) aux)[index]++;
+}
+
+void test_runs_every_task_once() {
+    const size_t N = 1000;
+    int *counts = calloc(N, sizeof(int));
+    thread_pool_t *pool = thread_pool_init(4);
+    assert(thread_pool_size(pool) >= 1);
+    for (size_t batch = 0; batch < 50; batch++) {
+        thread_pool_run(pool, batch == 0 ? 0 : N, count_task, counts);
+    }
+    for (size_t i = 0; i < N; i++) {
+        assert(counts[i] == 49);
+    }
+    thread_pool_free(pool);
+    free(counts);
+}
+
+void test_single_thread() {
+    int counts[3] = {0};
+    thread_pool_t *pool = thread_pool_init(1);
+    assert(thread_pool_size(pool) == 1);
+    thread_pool_run(pool, 3, count_task, counts);
+    assert(counts[0] == 1 && counts[1] == 1 && counts[2] == 1);
+    thread_pool_free(pool);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_runs_every_task_once)
+    DO_TEST(test_single_thread)
+
+    puts("thread_pool_test PASS");
+}